@@ -0,0 +1,865 @@
+#include "vector.h"
+#include "block_cache.h"
+#include "devector.h"
+#include "flat_map.h"
+#include "segmented_vector.h"
+#include "simd_algorithms.h"
+#include "test_utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+// Сколько раз повторяется каждый замер, в результат идет лучший
+const int REPETITIONS = 5;
+
+// Тип размером с кеш-линию
+struct Pod64 {
+    int64_t values[8];
+};
+
+// Тип, считающий вызовы своих специальных функций-членов
+struct C {
+    C() noexcept {
+        ++def_ctor;
+    }
+    C(const C& /*other*/) noexcept {
+        ++copy_ctor;
+    }
+    C(C&& /*other*/) noexcept {
+        ++move_ctor;
+    }
+    C& operator=(const C& other) noexcept {
+        if (this != &other) {
+            ++copy_assign;
+        }
+        return *this;
+    }
+    C& operator=(C&& /*other*/) noexcept {
+        ++move_assign;
+        return *this;
+    }
+    ~C() {
+        ++dtor;
+    }
+
+    static void Reset() {
+        def_ctor = 0;
+        copy_ctor = 0;
+        move_ctor = 0;
+        copy_assign = 0;
+        move_assign = 0;
+        dtor = 0;
+    }
+
+    inline static size_t def_ctor = 0;
+    inline static size_t copy_ctor = 0;
+    inline static size_t move_ctor = 0;
+    inline static size_t copy_assign = 0;
+    inline static size_t move_assign = 0;
+    inline static size_t dtor = 0;
+};
+
+template <typename T>
+using StdVector = std::vector<T, CountingAllocator<T>>;
+template <typename T>
+using OurVector = Vector<T, CountingAllocator<T>>;
+
+/**
+ * Не дает компилятору удалить вычисление значения value
+*/
+template <typename T>
+void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * Создает i-й элемент для наполнения контейнера
+*/
+template <typename T>
+T MakeValue(size_t i) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        // Строки длиннее буфера малой строки хранят данные в куче
+        return std::string(32, static_cast<char>('a' + i % 26));
+    }
+    else if constexpr (std::is_same_v<T, Pod64>) {
+        Pod64 pod{};
+        pod.values[0] = static_cast<int64_t>(i);
+        return pod;
+    }
+    else if constexpr (std::is_same_v<T, Obj>) {
+        return Obj(static_cast<int>(i));
+    }
+    else {
+        return static_cast<T>(i);
+    }
+}
+
+/**
+ * Извлекает из элемента число, по которому проверяется работа итерации
+*/
+template <typename T>
+int64_t Key(const T& value) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return static_cast<int64_t>(value.size());
+    }
+    else if constexpr (std::is_same_v<T, Pod64>) {
+        return value.values[0];
+    }
+    else if constexpr (std::is_same_v<T, Obj>) {
+        return value.id;
+    }
+    else {
+        return static_cast<int64_t>(value);
+    }
+}
+
+// Obj, конструктор перемещения которого не noexcept: вектор переносит его копированием
+struct ThrowingMoveObj : Obj {
+    explicit ThrowingMoveObj(int id)
+        : Obj(id)
+    {}
+    ThrowingMoveObj(const ThrowingMoveObj& other) = default;
+    ThrowingMoveObj(ThrowingMoveObj&& other) noexcept(false)
+        : Obj(std::move(other))
+    {}
+};
+
+// Строка в куче с noexcept-перемещением или без него
+template <bool NothrowMove>
+struct StringBox {
+    explicit StringBox(size_t i)
+        : value(MakeValue<std::string>(i))
+    {}
+    StringBox(const StringBox& other) = default;
+    StringBox(StringBox&& other) noexcept(NothrowMove)
+        : value(std::move(other.value))
+    {}
+
+    std::string value;
+};
+
+// Единый интерфейс к Vector и std::vector
+
+template <typename T>
+void Append(StdVector<T>& v, const T& value) {
+    v.push_back(value);
+}
+template <typename T>
+void Append(OurVector<T>& v, const T& value) {
+    v.PushBack(value);
+}
+template <typename T>
+void EmplaceAppend(StdVector<T>& v, size_t i) {
+    v.emplace_back(MakeValue<T>(i));
+}
+template <typename T>
+void EmplaceAppend(OurVector<T>& v, size_t i) {
+    v.EmplaceBack(MakeValue<T>(i));
+}
+template <typename T>
+void InsertAt(StdVector<T>& v, size_t index, const T& value) {
+    v.insert(v.begin() + index, value);
+}
+template <typename T>
+void InsertAt(OurVector<T>& v, size_t index, const T& value) {
+    v.Insert(v.begin() + index, value);
+}
+template <typename T>
+void EraseAt(StdVector<T>& v, size_t index) {
+    v.erase(v.begin() + index);
+}
+template <typename T>
+void EraseAt(OurVector<T>& v, size_t index) {
+    v.Erase(v.begin() + index);
+}
+template <typename T>
+void ReserveFor(StdVector<T>& v, size_t n) {
+    v.reserve(n);
+}
+template <typename T>
+void ReserveFor(OurVector<T>& v, size_t n) {
+    v.Reserve(n);
+}
+template <typename T>
+size_t SizeOf(const StdVector<T>& v) {
+    return v.size();
+}
+template <typename T>
+size_t SizeOf(const OurVector<T>& v) {
+    return v.Size();
+}
+
+template <typename Container>
+Container MakeContainer(size_t size) {
+    using T = typename Container::allocator_type::value_type;
+    Container v;
+    ReserveFor(v, size);
+    for (size_t i = 0; i < size; ++i) {
+        Append(v, MakeValue<T>(i));
+    }
+    return v;
+}
+
+// Результат замера
+struct Measurement {
+    double ns_per_op = 0.0;
+    size_t allocations = 0;
+    size_t allocated_bytes = 0;
+    size_t peak_bytes = 0;
+    // Байты, перенесенные конструкторами копирования и перемещения.
+    // Известны только для типов, считающих свои операции
+    int64_t moved_bytes = -1;
+};
+
+/**
+ * Замеряет операцию, выполняющую ops действий. prepare вызывается перед каждым повтором
+ * вне замера и возвращает состояние, передаваемое в run
+*/
+template <typename T, typename Prepare, typename Run>
+Measurement Measure(size_t ops, Prepare prepare, Run run) {
+    using namespace std::chrono;
+
+    Measurement best;
+    best.ns_per_op = -1.0;
+    for (int repetition = 0; repetition < REPETITIONS; ++repetition) {
+        auto state = prepare();
+
+        Obj::ResetCounters();
+        AllocationStats::Reset();
+        const auto start = steady_clock::now();
+        run(state);
+        const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+        const double ns_per_op = static_cast<double>(elapsed) / static_cast<double>(ops);
+        if (best.ns_per_op < 0 || ns_per_op < best.ns_per_op) {
+            best.ns_per_op = ns_per_op;
+            best.allocations = AllocationStats::num_allocations;
+            best.allocated_bytes = AllocationStats::allocated_bytes;
+            best.peak_bytes = AllocationStats::peak_bytes;
+            if constexpr (std::is_same_v<T, Obj>) {
+                best.moved_bytes = static_cast<int64_t>(Obj::num_moved + Obj::num_copied)
+                    * static_cast<int64_t>(sizeof(Obj));
+            }
+        }
+    }
+    return best;
+}
+
+void PrintHeader() {
+    using namespace std;
+    cout << left << setw(22) << "operation"sv << setw(13) << "type"sv << setw(13) << "container"sv
+         << right << setw(12) << "ns/op"sv << setw(10) << "allocs"sv << setw(14) << "bytes alloc"sv
+         << setw(14) << "peak bytes"sv << setw(14) << "bytes moved"sv << '\n';
+}
+
+void PrintRow(std::string_view operation, std::string_view type, std::string_view container,
+        const Measurement& m) {
+    using namespace std;
+    cout << left << setw(22) << operation << setw(13) << type << setw(13) << container
+         << right << fixed << setprecision(2) << setw(12) << m.ns_per_op
+         << setw(10) << m.allocations << setw(14) << m.allocated_bytes << setw(14) << m.peak_bytes << setw(14);
+    if (m.moved_bytes < 0) {
+        cout << "-"sv;
+    } else {
+        cout << m.moved_bytes;
+    }
+    cout << '\n';
+}
+
+// Размеры, на которых проводятся замеры
+const size_t APPEND_COUNT = 100'000;
+const size_t SHIFT_SIZE = 10'000;
+const size_t SHIFT_COUNT = 1'000;
+const size_t COPY_SIZE = 10'000;
+const size_t COPY_COUNT = 100;
+
+template <typename Container>
+void RunSuite(std::string_view type, std::string_view container) {
+    using T = typename Container::allocator_type::value_type;
+
+    PrintRow("PushBack"sv, type, container, Measure<T>(APPEND_COUNT,
+        [] {
+            return std::pair{Container{}, MakeValue<T>(1)};
+        },
+        [](auto& state) {
+            for (size_t i = 0; i < APPEND_COUNT; ++i) {
+                Append(state.first, state.second);
+            }
+            DoNotOptimize(state.first);
+        }));
+
+    PrintRow("EmplaceBack"sv, type, container, Measure<T>(APPEND_COUNT,
+        [] {
+            return Container{};
+        },
+        [](Container& v) {
+            for (size_t i = 0; i < APPEND_COUNT; ++i) {
+                EmplaceAppend(v, i);
+            }
+            DoNotOptimize(v);
+        }));
+
+    // Время одного Reserve, отнесенное к количеству перенесенных элементов
+    PrintRow("Reserve x2"sv, type, container, Measure<T>(APPEND_COUNT,
+        [] {
+            return MakeContainer<Container>(APPEND_COUNT);
+        },
+        [](Container& v) {
+            ReserveFor(v, APPEND_COUNT * 2);
+            DoNotOptimize(v);
+        }));
+
+    const std::pair<std::string_view, double> positions[] = {
+        {"front"sv, 0.0}, {"middle"sv, 0.5}, {"back"sv, 1.0}};
+    for (const auto& [name, fraction] : positions) {
+        const std::string insert_name = "Insert "s + std::string(name);
+        PrintRow(insert_name, type, container, Measure<T>(SHIFT_COUNT,
+            [] {
+                return std::pair{MakeContainer<Container>(SHIFT_SIZE), MakeValue<T>(1)};
+            },
+            [fraction = fraction](auto& state) {
+                for (size_t i = 0; i < SHIFT_COUNT; ++i) {
+                    const size_t size = SizeOf(state.first);
+                    InsertAt(state.first, static_cast<size_t>(static_cast<double>(size) * fraction), state.second);
+                }
+                DoNotOptimize(state.first);
+            }));
+
+        const std::string erase_name = "Erase "s + std::string(name);
+        PrintRow(erase_name, type, container, Measure<T>(SHIFT_COUNT,
+            [] {
+                return MakeContainer<Container>(SHIFT_SIZE);
+            },
+            [fraction = fraction](Container& v) {
+                for (size_t i = 0; i < SHIFT_COUNT; ++i) {
+                    const size_t size = SizeOf(v);
+                    EraseAt(v, std::min(size - 1, static_cast<size_t>(static_cast<double>(size) * fraction)));
+                }
+                DoNotOptimize(v);
+            }));
+    }
+
+    PrintRow("Copy assignment"sv, type, container, Measure<T>(COPY_COUNT,
+        [] {
+            return std::pair{MakeContainer<Container>(COPY_SIZE), MakeContainer<Container>(COPY_SIZE / 2)};
+        },
+        [](auto& state) {
+            for (size_t i = 0; i < COPY_COUNT; ++i) {
+                state.second = state.first;
+                DoNotOptimize(state.second);
+            }
+        }));
+
+    // Повторное присваивание вектора того же размера, например буфера кадра:
+    // память приемника используется повторно
+    PrintRow("Copy assign (reuse)"sv, type, container, Measure<T>(COPY_COUNT,
+        [] {
+            return std::pair{MakeContainer<Container>(COPY_SIZE), MakeContainer<Container>(COPY_SIZE)};
+        },
+        [](auto& state) {
+            for (size_t i = 0; i < COPY_COUNT; ++i) {
+                state.second = state.first;
+                DoNotOptimize(state.second);
+            }
+        }));
+
+    PrintRow("Iteration"sv, type, container, Measure<T>(APPEND_COUNT,
+        [] {
+            return MakeContainer<Container>(APPEND_COUNT);
+        },
+        [](const Container& v) {
+            int64_t sum = 0;
+            for (const T& value : v) {
+                sum += Key(value);
+            }
+            DoNotOptimize(sum);
+        }));
+}
+
+template <typename T>
+void RunSuites(std::string_view type) {
+    RunSuite<StdVector<T>>(type, "std::vector"sv);
+    RunSuite<OurVector<T>>(type, "Vector"sv);
+}
+
+template <typename Growth>
+struct GrowthTraits : DefaultVectorTraits {
+    using GrowthPolicy = Growth;
+};
+
+template <typename Growth>
+void RunGrowthPolicy(std::string_view name) {
+    using Container = Vector<size_t, CountingAllocator<size_t>, GrowthTraits<Growth>>;
+
+    const size_t NUM = 1'000'000;
+    const Measurement m = Measure<size_t>(NUM,
+        [] {
+            return Container{};
+        },
+        [](Container& v) {
+            for (size_t i = 0; i < NUM; ++i) {
+                v.PushBack(i);
+            }
+            DoNotOptimize(v);
+        });
+    PrintRow("PushBack"sv, "size_t"sv, name, m);
+}
+
+/**
+ * Замеряет очередь со скользящим окном: добавление в один конец и удаление из другого
+*/
+void RunSlidingWindow() {
+    const size_t WINDOW = 1'000;
+    const size_t NUM = 100'000;
+
+    PrintRow("Sliding window"sv, "int"sv, "Vector"sv, Measure<int>(NUM,
+        [] {
+            return OurVector<int>(WINDOW);
+        },
+        [](OurVector<int>& v) {
+            for (size_t i = 0; i < NUM; ++i) {
+                v.Emplace(v.cbegin(), static_cast<int>(i));
+                v.PopBack();
+            }
+            DoNotOptimize(v);
+        }));
+    PrintRow("Sliding window"sv, "int"sv, "std::deque"sv, Measure<int>(NUM,
+        [] {
+            return std::deque<int, CountingAllocator<int>>(WINDOW);
+        },
+        [](auto& q) {
+            for (size_t i = 0; i < NUM; ++i) {
+                q.push_front(static_cast<int>(i));
+                q.pop_back();
+            }
+            DoNotOptimize(q);
+        }));
+    PrintRow("Sliding window"sv, "int"sv, "Devector"sv, Measure<int>(NUM,
+        [] {
+            return Devector<int, CountingAllocator<int>>(WINDOW);
+        },
+        [](auto& q) {
+            for (size_t i = 0; i < NUM; ++i) {
+                q.PushFront(static_cast<int>(i));
+                q.PopBack();
+            }
+            DoNotOptimize(q);
+        }));
+}
+
+/**
+ * Сравнивает добавление в конец с переносом элементов при росте и без него
+*/
+template <typename T>
+void RunSegmentedAppend(std::string_view type) {
+    PrintRow("Append"sv, type, "Vector"sv, Measure<T>(APPEND_COUNT,
+        [] {
+            return OurVector<T>();
+        },
+        [](OurVector<T>& v) {
+            for (size_t i = 0; i < APPEND_COUNT; ++i) {
+                EmplaceAppend(v, i);
+            }
+            DoNotOptimize(v);
+        }));
+    PrintRow("Append"sv, type, "Segmented"sv, Measure<T>(APPEND_COUNT,
+        [] {
+            return SegmentedVector<T, CountingAllocator<T>>();
+        },
+        [](auto& v) {
+            for (size_t i = 0; i < APPEND_COUNT; ++i) {
+                v.EmplaceBack(MakeValue<T>(i));
+            }
+            DoNotOptimize(v);
+        }));
+}
+
+/**
+ * Замеряет алгоритм std:: и его векторную версию над одним и тем же вектором
+*/
+template <typename T, typename StdRun, typename SimdRun>
+void RunSimdPair(std::string_view operation, std::string_view type, StdRun std_run, SimdRun simd_run) {
+    const size_t SIZE = 1'000'000;
+    auto prepare = [] {
+        Vector<T> v(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i] = static_cast<T>(i % 1000);
+        }
+        return v;
+    };
+    PrintRow(operation, type, "std::"sv, Measure<T>(SIZE, prepare, [&std_run](Vector<T>& v) {
+        DoNotOptimize(std_run(v));
+    }));
+    PrintRow(operation, type, "SIMD"sv, Measure<T>(SIZE, prepare, [&simd_run](Vector<T>& v) {
+        DoNotOptimize(simd_run(v));
+    }));
+}
+
+template <typename T>
+void RunSimdAlgorithms(std::string_view type) {
+    // Значение, которого нет в векторе: поиск проходит его целиком
+    const T missing = static_cast<T>(-1);
+    RunSimdPair<T>("Find"sv, type,
+        [missing](const Vector<T>& v) {
+            return std::find(v.begin(), v.end(), missing);
+        },
+        [missing](const Vector<T>& v) {
+            return Find(v, missing);
+        });
+    RunSimdPair<T>("Count"sv, type,
+        [](const Vector<T>& v) {
+            return std::count(v.begin(), v.end(), T{7});
+        },
+        [](const Vector<T>& v) {
+            return Count(v, T{7});
+        });
+    RunSimdPair<T>("MinMax"sv, type,
+        [](const Vector<T>& v) {
+            const auto [min, max] = std::minmax_element(v.begin(), v.end());
+            return *min + *max;
+        },
+        [](const Vector<T>& v) {
+            const auto [min, max] = MinMax(v);
+            return min + max;
+        });
+    RunSimdPair<T>("Sum"sv, type,
+        [](const Vector<T>& v) {
+            return std::accumulate(v.begin(), v.end(), T{});
+        },
+        [](const Vector<T>& v) {
+            return Sum(v);
+        });
+    const Vector<T> other = [] {
+        Vector<T> v(1'000'000);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            v[i] = static_cast<T>(i % 1000);
+        }
+        return v;
+    }();
+    RunSimdPair<T>("Equal"sv, type,
+        [&other](const Vector<T>& v) {
+            return std::equal(v.begin(), v.end(), other.begin());
+        },
+        [&other](const Vector<T>& v) {
+            return Equal(v, other);
+        });
+    RunSimdPair<T>("Fill"sv, type,
+        [](Vector<T>& v) {
+            std::fill(v.begin(), v.end(), T{3});
+            return v.Data();
+        },
+        [](Vector<T>& v) {
+            Fill(v, T{3});
+            return v.Data();
+        });
+}
+
+/**
+ * Создает и разрушает короткоживущие векторы, как обработчик запроса
+*/
+template <typename Container>
+void RunShortLived(std::string_view container) {
+    const size_t NUM = 100'000;
+    const int ELEMENTS = 32;
+    PrintRow("Short-lived vectors"sv, "int"sv, container, Measure<int>(NUM,
+        [] {
+            return 0;
+        },
+        [](int&) {
+            for (size_t i = 0; i < NUM; ++i) {
+                Container v;
+                for (int j = 0; j < ELEMENTS; ++j) {
+                    v.PushBack(j);
+                }
+                DoNotOptimize(v);
+            }
+        }));
+}
+
+/**
+ * Заполняет вектор байт фрагментами по 1500 байт, как при чтении из сети:
+ * поэлементно через PushBack и записью прямо в хвост через GetWriteBuffer
+*/
+void RunChunkedFill() {
+    const size_t CHUNK = 1500;
+    const size_t NUM_CHUNKS = 1000;
+    const std::string packet(CHUNK, 'p');
+    PrintRow("Chunked fill"sv, "char"sv, "PushBack"sv, Measure<char>(CHUNK * NUM_CHUNKS,
+        [] {
+            return OurVector<char>();
+        },
+        [&packet](OurVector<char>& v) {
+            for (size_t i = 0; i < NUM_CHUNKS; ++i) {
+                v.Reserve(v.Size() + packet.size());
+                for (char c : packet) {
+                    v.PushBack(c);
+                }
+            }
+            DoNotOptimize(v);
+        }));
+    PrintRow("Chunked fill"sv, "char"sv, "WriteBuffer"sv, Measure<char>(CHUNK * NUM_CHUNKS,
+        [] {
+            return OurVector<char>();
+        },
+        [&packet](OurVector<char>& v) {
+            for (size_t i = 0; i < NUM_CHUNKS; ++i) {
+                const WriteBuffer<char> buffer = v.GetWriteBuffer(packet.size());
+                std::memcpy(buffer.data, packet.data(), packet.size());
+                v.Commit(packet.size());
+            }
+            DoNotOptimize(v);
+        }));
+}
+
+/**
+ * Замеряет рост вектора без Reserve для типа T и выводит число элементов,
+ * перенесенных копированием вместо перемещения
+*/
+template <typename Counted, typename T, typename Make>
+void RunGrowthWithFallback(std::string_view type, Make make) {
+    ResetCopyFallbackStats();
+    const Measurement m = Measure<Counted>(APPEND_COUNT,
+        [] {
+            return OurVector<T>();
+        },
+        [&make](OurVector<T>& v) {
+            for (size_t i = 0; i < APPEND_COUNT; ++i) {
+                v.EmplaceBack(make(i));
+            }
+            DoNotOptimize(v);
+        });
+    PrintRow("Grow, no Reserve"sv, type, "Vector"sv, m);
+    const CopyFallbackStats fallbacks = GetCopyFallbackStats();
+    // Счетчики накоплены за все повторы замера
+    std::cout << "    copy fallbacks per run: " << fallbacks.operations / REPETITIONS << " reallocations, "
+              << fallbacks.elements / REPETITIONS << " elements\n";
+}
+
+/**
+ * Стоимость гарантии строгой безопасности исключений: типы без noexcept-перемещения
+ * переносятся при росте копированием
+*/
+void RunExceptionGuaranteeCost() {
+    RunGrowthWithFallback<Obj, Obj>("Obj"sv, [](size_t i) {
+        return static_cast<int>(i);
+    });
+    RunGrowthWithFallback<Obj, ThrowingMoveObj>("ThrowMoveObj"sv, [](size_t i) {
+        return static_cast<int>(i);
+    });
+    RunGrowthWithFallback<int, StringBox<true>>("String"sv, [](size_t i) {
+        return i;
+    });
+    RunGrowthWithFallback<int, StringBox<false>>("ThrowString"sv, [](size_t i) {
+        return i;
+    });
+}
+
+void PrintCountersHeader() {
+    using namespace std;
+    cout << left << setw(22) << "operation"sv << setw(13) << "container"sv
+         << right << setw(10) << "def"sv << setw(10) << "copy"sv << setw(10) << "move"sv
+         << setw(10) << "copy="sv << setw(10) << "move="sv << setw(10) << "dtor"sv << '\n';
+}
+
+void PrintCounters(std::string_view operation, std::string_view container) {
+    using namespace std;
+    cout << left << setw(22) << operation << setw(13) << container
+         << right << setw(10) << C::def_ctor << setw(10) << C::copy_ctor << setw(10) << C::move_ctor
+         << setw(10) << C::copy_assign << setw(10) << C::move_assign << setw(10) << C::dtor << '\n';
+}
+
+using FlatInt64Map = FlatMap<int64_t, int64_t>;
+
+// Заполняет словарь парами; FlatMap строится одной сортировкой со слиянием
+template <typename Map>
+void BuildMap(Map& map, const std::vector<std::pair<int64_t, int64_t>>& pairs) {
+    if constexpr (std::is_same_v<Map, FlatInt64Map>) {
+        map.InsertRange(pairs.begin(), pairs.end());
+    } else {
+        if constexpr (std::is_same_v<Map, std::unordered_map<int64_t, int64_t>>) {
+            map.reserve(pairs.size());
+        }
+        map.insert(pairs.begin(), pairs.end());
+    }
+}
+
+// Возвращает значение по ключу или 0
+template <typename Map>
+int64_t FindValue(const Map& map, int64_t key) {
+    const auto it = map.find(key);
+    return it != map.end() ? it->second : 0;
+}
+int64_t FindValue(const FlatInt64Map& map, int64_t key) {
+    const auto it = map.Find(key);
+    return it != map.end() ? it->second : 0;
+}
+
+template <typename Map>
+void RunMapLookup(std::string_view size_name, std::string_view container,
+        const std::vector<std::pair<int64_t, int64_t>>& pairs, const std::vector<int64_t>& queries) {
+    // Построение больших контейнеров слишком долгое для повторов Measure, оно замеряется до 1M
+    if (pairs.size() <= 1'000'000) {
+        PrintRow("Build "s + std::string(size_name), "int64_t"sv, container, Measure<int64_t>(pairs.size(),
+            [] {
+                return Map();
+            },
+            [&pairs](Map& map) {
+                BuildMap(map, pairs);
+                DoNotOptimize(map);
+            }));
+    }
+    Map map;
+    BuildMap(map, pairs);
+    PrintRow("Lookup "s + std::string(size_name), "int64_t"sv, container, Measure<int64_t>(queries.size(),
+        [] {
+            return int64_t{0};
+        },
+        [&map, &queries](int64_t& sum) {
+            for (int64_t key : queries) {
+                sum += FindValue(map, key);
+            }
+            DoNotOptimize(sum);
+        }));
+}
+
+/**
+ * Сравнивает построение и поиск в FlatMap, std::map и std::unordered_map
+ * на size случайных ключах
+*/
+void RunFlatMapLookup(size_t size, std::string_view size_name) {
+    const size_t LOOKUPS = 1'000'000;
+    std::vector<std::pair<int64_t, int64_t>> pairs(size);
+    uint64_t state = 42;
+    for (size_t i = 0; i < size; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        pairs[i] = {static_cast<int64_t>(state >> 1), static_cast<int64_t>(i)};
+    }
+    // Запросы попадают в случайные ключи, каждый восьмой отсутствует
+    std::vector<int64_t> queries(LOOKUPS);
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        queries[i] = i % 8 == 0 ? static_cast<int64_t>(state >> 1) : pairs[(state >> 33) % size].first;
+    }
+    RunMapLookup<FlatInt64Map>(size_name, "FlatMap"sv, pairs, queries);
+    RunMapLookup<std::map<int64_t, int64_t>>(size_name, "std::map"sv, pairs, queries);
+    RunMapLookup<std::unordered_map<int64_t, int64_t>>(size_name, "unordered_map"sv, pairs, queries);
+}
+
+/**
+ * Считает операции над элементами при SHIFT_COUNT вставках в середину вектора
+ * без переаллокации. Каждая вставка сдвигает половину элементов
+*/
+template <typename Container>
+void RunElementOperations(std::string_view container) {
+    const auto run = [container](std::string_view operation, auto insert) {
+        Container v(SHIFT_SIZE);
+        v.reserve(SHIFT_SIZE + SHIFT_COUNT);
+        C value;
+        C::Reset();
+        for (size_t i = 0; i < SHIFT_COUNT; ++i) {
+            insert(v, v.begin() + static_cast<std::ptrdiff_t>(v.size() / 2), value);
+        }
+        PrintCounters(operation, container);
+    };
+
+    run("Emplace()"sv, [](Container& v, auto pos, C& /*value*/) {
+        v.emplace(pos);
+    });
+    run("Insert(T&&)"sv, [](Container& v, auto pos, C& value) {
+        v.insert(pos, std::move(value));
+    });
+    run("Insert(const T&)"sv, [](Container& v, auto pos, C& value) {
+        v.insert(pos, std::as_const(value));
+    });
+    run("Insert at end"sv, [](Container& v, auto /*pos*/, C& value) {
+        v.insert(v.end(), value);
+    });
+}
+
+// Адаптер, дающий Vector интерфейс std::vector, используемый RunElementOperations
+struct OurCVector : Vector<C> {
+    using Vector<C>::Vector;
+
+    void reserve(size_t n) {
+        Reserve(n);
+    }
+    size_t size() const noexcept {
+        return Size();
+    }
+    template <typename... Types>
+    void emplace(const_iterator pos, Types&&... args) {
+        Emplace(pos, std::forward<Types>(args)...);
+    }
+    template <typename Value>
+    void insert(const_iterator pos, Value&& value) {
+        Insert(pos, std::forward<Value>(value));
+    }
+};
+
+}  // namespace
+
+int main() {
+    PrintHeader();
+    RunSuites<int>("int"sv);
+    RunSuites<std::string>("std::string"sv);
+    RunSuites<Pod64>("Pod64"sv);
+    RunSuites<Obj>("Obj"sv);
+
+    std::cout << '\n';
+    PrintHeader();
+    RunGrowthPolicy<DoublingGrowth>("2x"sv);
+    RunGrowthPolicy<GoldenGrowth>("1.5x"sv);
+    RunGrowthPolicy<GeometricGrowth<2, 1, 16>>("2x, min 16"sv);
+    RunGrowthPolicy<PageRoundedGrowth<GoldenGrowth>>("1.5x, page"sv);
+
+    std::cout << '\n';
+    PrintHeader();
+    RunSlidingWindow();
+    RunSegmentedAppend<int>("int"sv);
+    RunSegmentedAppend<Obj>("Obj"sv);
+    RunShortLived<Vector<int>>("Vector"sv);
+    RunShortLived<CachedVector<int>>("CachedVector"sv);
+    RunChunkedFill();
+
+    std::cout << '\n';
+    PrintHeader();
+    RunExceptionGuaranteeCost();
+
+    std::cout << '\n';
+    PrintHeader();
+    RunFlatMapLookup(1'000, "1K"sv);
+    RunFlatMapLookup(100'000, "100K"sv);
+    RunFlatMapLookup(1'000'000, "1M"sv);
+    RunFlatMapLookup(10'000'000, "10M"sv);
+
+    std::cout << '\n';
+    PrintHeader();
+    RunSimdAlgorithms<int32_t>("int32_t"sv);
+    RunSimdAlgorithms<float>("float"sv);
+
+    std::cout << '\n';
+    PrintCountersHeader();
+    RunElementOperations<std::vector<C>>("std::vector"sv);
+    RunElementOperations<OurCVector>("Vector"sv);
+}
@@ -0,0 +1,289 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+/**
+ * Статистика кеша блоков текущего потока
+*/
+struct BlockCacheStats {
+    size_t hits = 0;            // Выделения, обслуженные блоком из кеша
+    size_t misses = 0;          // Выделения, обратившиеся к operator new
+    size_t bypassed = 0;        // Выделения крупнее MAX_CLASS_BYTES, кеш не используется
+    size_t released = 0;        // Блоки, возвращенные operator delete: список полон или вызван Trim
+    size_t cached_blocks = 0;   // Блоки, хранящиеся в кеше сейчас
+    size_t cached_bytes = 0;    // Их суммарный размер
+};
+
+/**
+ * Кеш освобожденных блоков памяти, свой у каждого потока. Блоки размером до MAX_CLASS_BYTES
+ * округляются вверх до степени двойки и после освобождения попадают в список своего класса,
+ * откуда их забирают следующие выделения того же класса, не обращаясь к operator new.
+ * Каждый список хранит не больше MAX_BLOCKS_PER_CLASS блоков, поэтому кеш потока занимает
+ * не больше MAX_BLOCKS_PER_CLASS * (2 * MAX_CLASS_BYTES) байт. Блок может быть освобожден
+ * в другом потоке, он попадет в кеш освобождающего потока
+*/
+class BlockCache {
+public:
+    static constexpr size_t MIN_CLASS_SHIFT = 4;
+    static constexpr size_t MIN_CLASS_BYTES = size_t{1} << MIN_CLASS_SHIFT;
+    static constexpr size_t MAX_CLASS_SHIFT = 16;
+    static constexpr size_t MAX_CLASS_BYTES = size_t{1} << MAX_CLASS_SHIFT;
+    static constexpr size_t MAX_BLOCKS_PER_CLASS = 32;
+
+    BlockCache() = default;
+    BlockCache(const BlockCache&) = delete;
+    BlockCache& operator=(const BlockCache&) = delete;
+    ~BlockCache() noexcept;
+
+    static BlockCache& Local() noexcept;
+    static void* AllocateLocal(size_t bytes);
+    static void DeallocateLocal(void* block, size_t bytes) noexcept;
+
+    void* Allocate(size_t bytes);
+    void Deallocate(void* block, size_t bytes) noexcept;
+    void Trim() noexcept;
+
+    static size_t ClassBytes(size_t bytes) noexcept;
+
+    const BlockCacheStats& Stats() const noexcept;
+    void ResetStats() noexcept;
+
+private:
+    static constexpr size_t NUM_CLASSES = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+
+    // Узел списка хранится в самом свободном блоке
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    FreeBlock* free_lists_[NUM_CLASSES] = {};
+    size_t list_sizes_[NUM_CLASSES] = {};
+    BlockCacheStats stats_;
+
+    static BlockCache* LocalOrNull() noexcept;
+    static size_t ClassIndex(size_t bytes) noexcept;
+};
+
+/**
+ * Аллокатор, выделяющий память через кеш блоков текущего потока
+*/
+template <typename T>
+struct BlockCacheAllocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+        "BlockCacheAllocator does not support over-aligned types");
+
+    static constexpr size_t ALIGNMENT = std::max(alignof(T), size_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__});
+
+    BlockCacheAllocator() = default;
+    template <typename U>
+    BlockCacheAllocator(const BlockCacheAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(BlockCache::AllocateLocal(n * sizeof(T)));
+    }
+    void deallocate(T* buf, size_t n) noexcept {
+        BlockCache::DeallocateLocal(buf, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const BlockCacheAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const BlockCacheAllocator<U>& /*other*/) const noexcept {
+        return false;
+    }
+};
+
+/**
+ * Политика-адаптер роста для BlockCacheAllocator: дополняет вместимость, вычисленную
+ * политикой Base, до размера класса блока, чтобы округленный блок использовался целиком
+*/
+template <typename Base>
+struct BlockCacheGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t base = Base::NextCapacity(capacity, required, element_size);
+        if (base > BlockCache::MAX_CLASS_BYTES / element_size) {
+            return base;
+        }
+        return BlockCache::ClassBytes(base * element_size) / element_size;
+    }
+};
+
+struct BlockCacheTraits : DefaultVectorTraits {
+    using GrowthPolicy = BlockCacheGrowth<DoublingGrowth>;
+};
+
+template <typename T>
+using CachedVector = Vector<T, BlockCacheAllocator<T>, BlockCacheTraits>;
+
+/**
+ * Деструктор, возвращает закешированные блоки operator delete при завершении потока
+*/
+inline BlockCache::~BlockCache() noexcept {
+    Trim();
+}
+
+/**
+ * Возвращает кеш текущего потока
+*/
+inline BlockCache& BlockCache::Local() noexcept {
+    BlockCache* cache = LocalOrNull();
+    assert(cache != nullptr);
+    return *cache;
+}
+/**
+ * Выделяет блок через кеш текущего потока. После разрушения кеша при завершении
+ * потока (деструкторы статических объектов) блок выделяется operator new
+*/
+inline void* BlockCache::AllocateLocal(size_t bytes) {
+    if (BlockCache* cache = LocalOrNull()) {
+        return cache->Allocate(bytes);
+    }
+    return operator new(ClassBytes(bytes));
+}
+/**
+ * Освобождает блок через кеш текущего потока или operator delete, если кеш уже разрушен
+*/
+inline void BlockCache::DeallocateLocal(void* block, size_t bytes) noexcept {
+    if (BlockCache* cache = LocalOrNull()) {
+        cache->Deallocate(block, bytes);
+    } else {
+        operator delete(block);
+    }
+}
+
+/**
+ * Выделяет блок не меньше bytes байт, по возможности из кеша
+*/
+inline void* BlockCache::Allocate(size_t bytes) {
+    if (bytes > MAX_CLASS_BYTES) {
+        ++stats_.bypassed;
+        return operator new(bytes);
+    }
+    const size_t index = ClassIndex(bytes);
+    if (FreeBlock* block = free_lists_[index]) {
+        free_lists_[index] = block->next;
+        --list_sizes_[index];
+        ++stats_.hits;
+        --stats_.cached_blocks;
+        stats_.cached_bytes -= MIN_CLASS_BYTES << index;
+        return block;
+    }
+    ++stats_.misses;
+    return operator new(MIN_CLASS_BYTES << index);
+}
+/**
+ * Освобождает блок, выделенный Allocate(bytes). Блок остается в кеше,
+ * если список его класса не заполнен
+*/
+inline void BlockCache::Deallocate(void* block, size_t bytes) noexcept {
+    if (block == nullptr) {
+        return;
+    }
+    if (bytes > MAX_CLASS_BYTES) {
+        operator delete(block);
+        return;
+    }
+    const size_t index = ClassIndex(bytes);
+    if (list_sizes_[index] == MAX_BLOCKS_PER_CLASS) {
+        ++stats_.released;
+        operator delete(block);
+        return;
+    }
+    free_lists_[index] = new (block) FreeBlock{free_lists_[index]};
+    ++list_sizes_[index];
+    ++stats_.cached_blocks;
+    stats_.cached_bytes += MIN_CLASS_BYTES << index;
+}
+/**
+ * Освобождает все блоки, хранящиеся в кеше
+*/
+inline void BlockCache::Trim() noexcept {
+    for (size_t index = 0; index < NUM_CLASSES; ++index) {
+        while (FreeBlock* block = free_lists_[index]) {
+            free_lists_[index] = block->next;
+            operator delete(block);
+            ++stats_.released;
+        }
+        list_sizes_[index] = 0;
+    }
+    stats_.cached_blocks = 0;
+    stats_.cached_bytes = 0;
+}
+
+/**
+ * Возвращает размер блока, который кеш выделит под bytes байт
+*/
+inline size_t BlockCache::ClassBytes(size_t bytes) noexcept {
+    return bytes > MAX_CLASS_BYTES ? bytes : MIN_CLASS_BYTES << ClassIndex(bytes);
+}
+
+/**
+ * Возвращает статистику кеша
+*/
+inline const BlockCacheStats& BlockCache::Stats() const noexcept {
+    return stats_;
+}
+/**
+ * Обнуляет счетчики выделений, сведения о хранящихся блоках сохраняются
+*/
+inline void BlockCache::ResetStats() noexcept {
+    stats_.hits = 0;
+    stats_.misses = 0;
+    stats_.bypassed = 0;
+    stats_.released = 0;
+}
+
+/**
+ * Возвращает кеш текущего потока или nullptr, если он уже разрушен
+*/
+inline BlockCache* BlockCache::LocalOrNull() noexcept {
+    // Тривиальный флаг остается доступным до конца потока, в отличие от самого кеша
+    static thread_local bool destroyed = false;
+    struct Holder {
+        BlockCache cache;
+        ~Holder() {
+            destroyed = true;
+        }
+    };
+    if (destroyed) {
+        return nullptr;
+    }
+    static thread_local Holder holder;
+    return &holder.cache;
+}
+
+/**
+ * Номер класса для блока размером bytes <= MAX_CLASS_BYTES: класс index
+ * хранит блоки по MIN_CLASS_BYTES << index байт
+*/
+inline size_t BlockCache::ClassIndex(size_t bytes) noexcept {
+    if (bytes <= MIN_CLASS_BYTES) {
+        return 0;
+    }
+    // Показатель степени двойки, округленной вверх от bytes
+#if defined(__GNUC__) || defined(__clang__)
+    const size_t shift = sizeof(unsigned long long) * 8
+        - __builtin_clzll(static_cast<unsigned long long>(bytes - 1));
+#else
+    size_t shift = 0;
+    for (size_t value = bytes - 1; value != 0; value >>= 1) {
+        ++shift;
+    }
+#endif
+    return shift - MIN_CLASS_SHIFT;
+}
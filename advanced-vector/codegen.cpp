@@ -0,0 +1,54 @@
+// Проверка кодогенерации: циклы, помеченные VECTORIZED, должны векторизоваться.
+// Сборка с отчетом векторизатора:
+//     g++ -std=c++17 -O3 -DNDEBUG -fopt-info-vec-optimized -c codegen.cpp -o /dev/null
+// Для каждой помеченной строки отчет содержит "loop vectorized"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+
+struct UncheckedTraits : DefaultVectorTraits {
+    using CheckPolicy = NoChecks;
+};
+
+struct HardenedTraits : DefaultVectorTraits {
+    using CheckPolicy = ThrowChecks;
+};
+
+// Редукция через UncheckedAt при политике по умолчанию
+int SumUnchecked(const Vector<int>& v) {
+    int sum = 0;
+    for (size_t i = 0; i < v.Size(); ++i) {  // VECTORIZED
+        sum += v.UncheckedAt(i);
+    }
+    return sum;
+}
+
+// operator[] без проверок
+void ScaleUnchecked(Vector<float, std::allocator<float>, UncheckedTraits>& v, float factor) {
+    for (size_t i = 0; i < v.Size(); ++i) {  // VECTORIZED
+        v[i] *= factor;
+    }
+}
+
+// Поэлементная операция над двумя векторами
+void AddUnchecked(Vector<double>& lhs, const Vector<double>& rhs) {
+    const size_t size = std::min(lhs.Size(), rhs.Size());
+    for (size_t i = 0; i < size; ++i) {  // VECTORIZED
+        lhs.UncheckedAt(i) += rhs.UncheckedAt(i);
+    }
+}
+
+// Усиленная сборка: проверки выполняются один раз на границе диапазона, цикл их не содержит
+long long SumHardened(const Vector<int, std::allocator<int>, HardenedTraits>& v, size_t first, size_t last) {
+    if (first >= last) {
+        return 0;
+    }
+    static_cast<void>(v[first]);
+    static_cast<void>(v[last - 1]);
+    long long sum = 0;
+    for (size_t i = first; i < last; ++i) {  // VECTORIZED
+        sum += v.UncheckedAt(i);
+    }
+    return sum;
+}
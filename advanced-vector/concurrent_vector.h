@@ -0,0 +1,325 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Вектор с конкурентным добавлением элементов. Элементы хранятся в сегментах
+ * геометрически растущего размера: сегмент k вмещает FIRST_SEGMENT_SIZE * 2^k элементов.
+ * Сегменты не перевыделяются, поэтому адреса элементов стабильны на всё время жизни вектора.
+ *
+ * EmplaceBack и чтение по индексу можно вызывать из разных потоков одновременно.
+ * Конструирование, разрушение, Reserve и Clear требуют внешней синхронизации
+*/
+template <typename T, typename Alloc = std::allocator<T>>
+class ConcurrentVector {
+public:
+    using allocator_type = Alloc;
+
+    static_assert(std::is_same_v<typename std::allocator_traits<Alloc>::value_type, T>,
+        "ConcurrentVector<T, Alloc> requires Alloc::value_type to be T");
+
+    static constexpr size_t FIRST_SEGMENT_SIZE = 8;
+
+    ConcurrentVector() noexcept(noexcept(Alloc()));
+    explicit ConcurrentVector(const Alloc& alloc) noexcept;
+
+    ConcurrentVector(const ConcurrentVector& other) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector& other) = delete;
+
+    ~ConcurrentVector() noexcept;
+
+    void Reserve(size_t n);
+    void Clear() noexcept;
+
+    template <typename... Types>
+    T& EmplaceBack(Types&&... args);
+    template <typename ValueType>
+    T& PushBack(ValueType&& value);
+
+    size_t Size() const noexcept;
+    bool IsReady(size_t index) const noexcept;
+
+    const T& operator[](size_t index) const noexcept;
+    T& operator[](size_t index) noexcept;
+
+    Vector<T, Alloc> Snapshot() const;
+
+    Alloc GetAllocator() const noexcept;
+
+private:
+    // Состояние ячейки сегмента
+    enum class SlotState : uint8_t {
+        EMPTY,      // Ячейка не занята или элемент еще конструируется
+        READY,      // Элемент сконструирован и опубликован
+        FAILED,     // Конструктор элемента выбросил исключение
+    };
+
+    struct Segment {
+        Segment(size_t size, const Alloc& alloc)
+            : data(size, alloc)
+            , states(new std::atomic<SlotState>[size]())
+        {
+        }
+
+        RawMemory<T, Alloc> data;
+        std::unique_ptr<std::atomic<SlotState>[]> states;
+    };
+
+    using Layout = detail::SegmentLayout<3>;
+    static_assert(Layout::FIRST_SIZE == FIRST_SEGMENT_SIZE);
+    static constexpr size_t MAX_SEGMENTS = Layout::MAX_SEGMENTS;
+
+    static size_t SegmentIndex(size_t index) noexcept;
+    static size_t SegmentOffset(size_t index, size_t segment) noexcept;
+    static size_t SegmentSize(size_t segment) noexcept;
+
+    Segment& GetSegment(size_t segment);
+    const Segment& ExistingSegment(size_t segment) const noexcept;
+    SlotState State(size_t index) const noexcept;
+
+    Alloc alloc_;
+    std::atomic<size_t> size_{0};
+    std::atomic<Segment*> segments_[MAX_SEGMENTS] = {};
+};
+
+/**
+ * Конструктор по умолчанию
+*/
+template <typename T, typename Alloc>
+ConcurrentVector<T, Alloc>::ConcurrentVector() noexcept(noexcept(Alloc()))
+    : alloc_()
+{
+}
+/**
+ * Конструктор пустого вектора с заданным аллокатором
+*/
+template <typename T, typename Alloc>
+ConcurrentVector<T, Alloc>::ConcurrentVector(const Alloc& alloc) noexcept
+    : alloc_(alloc)
+{
+}
+/**
+ * Деструктор. Разрушает сконструированные элементы и освобождает сегменты
+*/
+template <typename T, typename Alloc>
+ConcurrentVector<T, Alloc>::~ConcurrentVector() noexcept {
+    Clear();
+    for (std::atomic<Segment*>& segment : segments_) {
+        delete segment.load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Выделяет сегменты, необходимые для хранения n элементов
+*/
+template <typename T, typename Alloc>
+void ConcurrentVector<T, Alloc>::Reserve(size_t n) {
+    if (n == 0) {
+        return;
+    }
+    const size_t last = SegmentIndex(n - 1);
+    for (size_t segment = 0; segment <= last; ++segment) {
+        GetSegment(segment);
+    }
+}
+/**
+ * Разрушает все элементы, оставляя выделенные сегменты для повторного использования
+*/
+template <typename T, typename Alloc>
+void ConcurrentVector<T, Alloc>::Clear() noexcept {
+    const size_t size = size_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < size; ++i) {
+        const size_t segment = SegmentIndex(i);
+        Segment* s = segments_[segment].load(std::memory_order_relaxed);
+        // Ячейки невыделенного сегмента пусты
+        if (s == nullptr) {
+            continue;
+        }
+        std::atomic<SlotState>& state = s->states[SegmentOffset(i, segment)];
+        if (state.load(std::memory_order_relaxed) == SlotState::READY) {
+            std::destroy_at(s->data + SegmentOffset(i, segment));
+        }
+        state.store(SlotState::EMPTY, std::memory_order_relaxed);
+    }
+    size_.store(0, std::memory_order_release);
+}
+
+/**
+ * Добавляет элемент в конец вектора без блокировок: недостающий сегмент устанавливается
+ * через compare_exchange, затем индекс резервируется compare_exchange счетчика размера.
+ * Сегмент выделяется до публикации индекса, поэтому ошибка выделения не оставляет
+ * в векторе ячеек без сегмента. Возвращает ссылку на элемент, остающуюся действительной
+ * до Clear или разрушения вектора. Если конструктор выбросит исключение, ячейка
+ * помечается неудавшейся и пропускается Snapshot
+*/
+template <typename T, typename Alloc>
+template <typename... Types>
+T& ConcurrentVector<T, Alloc>::EmplaceBack(Types&&... args) {
+    size_t index = size_.load(std::memory_order_relaxed);
+    Segment* s = nullptr;
+    size_t offset = 0;
+    for (;;) {
+        const size_t segment = SegmentIndex(index);
+        s = &GetSegment(segment);
+        offset = SegmentOffset(index, segment);
+        // При неудаче index получает текущий размер, и сегмент выбирается заново
+        if (size_.compare_exchange_weak(index, index + 1, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    try {
+        new (s->data + offset) T(std::forward<Types>(args)...);
+    }
+    catch (...) {
+        s->states[offset].store(SlotState::FAILED, std::memory_order_release);
+        throw;
+    }
+    s->states[offset].store(SlotState::READY, std::memory_order_release);
+    return s->data[offset];
+}
+/**
+ * Добавляет копию или перемещенное значение value в конец вектора
+*/
+template <typename T, typename Alloc>
+template <typename ValueType>
+T& ConcurrentVector<T, Alloc>::PushBack(ValueType&& value) {
+    return EmplaceBack(std::forward<ValueType>(value));
+}
+
+/**
+ * Возвращает количество зарезервированных ячеек, включая элементы,
+ * которые еще конструируются другими потоками
+*/
+template <typename T, typename Alloc>
+size_t ConcurrentVector<T, Alloc>::Size() const noexcept {
+    return size_.load(std::memory_order_acquire);
+}
+/**
+ * Проверяет, что элемент с индексом index сконструирован и его можно читать
+*/
+template <typename T, typename Alloc>
+bool ConcurrentVector<T, Alloc>::IsReady(size_t index) const noexcept {
+    return index < Size() && State(index) == SlotState::READY;
+}
+
+/**
+ * Константный оператор индексации. Элемент должен быть опубликован (IsReady)
+*/
+template <typename T, typename Alloc>
+const T& ConcurrentVector<T, Alloc>::operator[](size_t index) const noexcept {
+    assert(IsReady(index));
+    const size_t segment = SegmentIndex(index);
+    return ExistingSegment(segment).data[SegmentOffset(index, segment)];
+}
+/**
+ * Оператор индексации. Элемент должен быть опубликован (IsReady)
+*/
+template <typename T, typename Alloc>
+T& ConcurrentVector<T, Alloc>::operator[](size_t index) noexcept {
+    return const_cast<T&>(std::as_const(*this)[index]);
+}
+
+/**
+ * Копирует элементы в непрерывный вектор. Копируется наибольший префикс, в котором
+ * нет конструируемых в данный момент элементов; неудавшиеся ячейки пропускаются
+*/
+template <typename T, typename Alloc>
+Vector<T, Alloc> ConcurrentVector<T, Alloc>::Snapshot() const {
+    const size_t size = Size();
+    size_t count = 0;
+    for (; count < size; ++count) {
+        if (State(count) == SlotState::EMPTY) {
+            break;
+        }
+    }
+
+    Vector<T, Alloc> result(alloc_);
+    result.Reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (State(i) == SlotState::READY) {
+            const size_t segment = SegmentIndex(i);
+            result.PushBack(ExistingSegment(segment).data[SegmentOffset(i, segment)]);
+        }
+    }
+    return result;
+}
+
+/**
+ * Возвращает копию аллокатора
+*/
+template <typename T, typename Alloc>
+Alloc ConcurrentVector<T, Alloc>::GetAllocator() const noexcept {
+    return alloc_;
+}
+
+/**
+ * Возвращает номер сегмента, хранящего элемент с индексом index
+*/
+template <typename T, typename Alloc>
+size_t ConcurrentVector<T, Alloc>::SegmentIndex(size_t index) noexcept {
+    return Layout::SegmentIndex(index);
+}
+/**
+ * Возвращает смещение элемента с индексом index внутри сегмента segment
+*/
+template <typename T, typename Alloc>
+size_t ConcurrentVector<T, Alloc>::SegmentOffset(size_t index, size_t segment) noexcept {
+    return Layout::SegmentOffset(index, segment);
+}
+/**
+ * Возвращает вместимость сегмента segment
+*/
+template <typename T, typename Alloc>
+size_t ConcurrentVector<T, Alloc>::SegmentSize(size_t segment) noexcept {
+    return Layout::SegmentSize(segment);
+}
+
+/**
+ * Возвращает сегмент, выделяя его при отсутствии. Если несколько потоков выделили
+ * сегмент одновременно, устанавливается первый, остальные освобождаются
+*/
+template <typename T, typename Alloc>
+typename ConcurrentVector<T, Alloc>::Segment& ConcurrentVector<T, Alloc>::GetSegment(size_t segment) {
+    assert(segment < MAX_SEGMENTS);
+    Segment* current = segments_[segment].load(std::memory_order_acquire);
+    if (current != nullptr) {
+        return *current;
+    }
+
+    auto created = std::make_unique<Segment>(SegmentSize(segment), alloc_);
+    if (segments_[segment].compare_exchange_strong(current, created.get(),
+            std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return *created.release();
+    }
+    return *current;
+}
+/**
+ * Возвращает уже выделенный сегмент
+*/
+template <typename T, typename Alloc>
+const typename ConcurrentVector<T, Alloc>::Segment& ConcurrentVector<T, Alloc>::ExistingSegment(
+        size_t segment) const noexcept {
+    const Segment* s = segments_[segment].load(std::memory_order_acquire);
+    assert(s != nullptr);
+    return *s;
+}
+/**
+ * Возвращает состояние ячейки с индексом index. Ячейка в еще не выделенном
+ * сегменте считается пустой
+*/
+template <typename T, typename Alloc>
+typename ConcurrentVector<T, Alloc>::SlotState ConcurrentVector<T, Alloc>::State(size_t index) const noexcept {
+    const size_t segment = SegmentIndex(index);
+    const Segment* s = segments_[segment].load(std::memory_order_acquire);
+    if (s == nullptr) {
+        return SlotState::EMPTY;
+    }
+    return s->states[SegmentOffset(index, segment)].load(std::memory_order_acquire);
+}
@@ -0,0 +1,502 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <utility>
+
+/**
+ * Вектор с копированием при записи: копии разделяют один неизменяемый буфер
+ * со счетчиком ссылок, поэтому копирование выполняется за O(1) и не расходует память.
+ * Элементы копируются при первом изменяющем вызове над разделяемым буфером.
+ *
+ * Неконстантные operator[], begin(), end() и Data() тоже считаются изменяющими и отделяют
+ * буфер. Для чтения используйте константный объект или cbegin()/cend(). Ссылки и итераторы,
+ * полученные до копирования вектора, указывают в разделяемый буфер: изменение через них
+ * видно всем копиям.
+ *
+ * Счетчик ссылок атомарный, поэтому копии одного вектора можно создавать, читать и
+ * изменять в разных потоках. Один объект CowVector, как и Vector, требует внешней
+ * синхронизации, если его изменяет хотя бы один поток
+*/
+template <typename T, typename Alloc = std::allocator<T>, typename Traits = DefaultVectorTraits>
+class CowVector {
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+    using VectorType = Vector<T, Alloc, Traits>;
+
+    CowVector() noexcept(noexcept(Alloc()));
+    explicit CowVector(const Alloc& alloc) noexcept;
+    explicit CowVector(size_t size, const Alloc& alloc = Alloc());
+    explicit CowVector(VectorType values);
+    CowVector(const CowVector& other) noexcept;
+    CowVector(CowVector&& other) noexcept;
+
+    CowVector& operator=(const CowVector& other) noexcept;
+    CowVector& operator=(CowVector&& other) noexcept;
+
+    ~CowVector() noexcept;
+
+    void Resize(size_t new_size);
+    void Reserve(size_t n);
+    void Clear() noexcept;
+
+    template <typename... Types>
+    T& EmplaceBack(Types&&... args);
+    template <typename ValueType>
+    void PushBack(ValueType&& value);
+
+    template <typename... Types>
+    iterator Emplace(const_iterator pos, Types&&... args);
+    template <typename ValueType>
+    iterator Insert(const_iterator pos, ValueType&& value);
+
+    void PopBack();
+    iterator Erase(const_iterator pos);
+
+    size_t Size() const noexcept;
+    size_t Capacity() const noexcept;
+    bool IsShared() const noexcept;
+    size_t UseCount() const noexcept;
+
+    const T& operator[](size_t index) const noexcept;
+    T& operator[](size_t index);
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    T* Data();
+    const T* Data() const noexcept;
+
+    VectorType ToVector() const;
+
+    void Swap(CowVector& other) noexcept;
+
+    Alloc GetAllocator() const noexcept;
+
+private:
+    // Разделяемый буфер: вектор элементов и количество ссылающихся на него CowVector
+    struct Block {
+        template <typename... Args>
+        explicit Block(Args&&... args)
+            : values(std::forward<Args>(args)...)
+        {}
+
+        std::atomic<size_t> refs{1};
+        VectorType values;
+    };
+
+    using BlockAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Block>;
+    using BlockTraits = std::allocator_traits<BlockAlloc>;
+
+    Alloc alloc_;
+    Block* block_ = nullptr; // Пустой вектор не выделяет буфер
+
+    template <typename... Args>
+    Block* CreateBlock(Args&&... args) const;
+    void ReleaseBlock() noexcept;
+
+    VectorType& Mutable(size_t capacity);
+    void DetachWithout(size_t first, size_t last);
+};
+
+/**
+ * Конструктор по умолчанию
+*/
+template <typename T, typename Alloc, typename Traits>
+CowVector<T, Alloc, Traits>::CowVector() noexcept(noexcept(Alloc()))
+    : alloc_()
+{}
+/**
+ * Конструктор, создает пустой вектор, использующий заданный аллокатор
+*/
+template <typename T, typename Alloc, typename Traits>
+CowVector<T, Alloc, Traits>::CowVector(const Alloc& alloc) noexcept
+    : alloc_(alloc)
+{}
+/**
+ * Конструктор, создает вектор заданного размера
+*/
+template <typename T, typename Alloc, typename Traits>
+CowVector<T, Alloc, Traits>::CowVector(size_t size, const Alloc& alloc)
+    : alloc_(alloc)
+{
+    if (size != 0) {
+        block_ = CreateBlock(size, alloc_);
+    }
+}
+/**
+ * Конструктор, забирает элементы вектора values без копирования
+*/
+template <typename T, typename Alloc, typename Traits>
+CowVector<T, Alloc, Traits>::CowVector(VectorType values)
+    : alloc_(values.GetAllocator())
+    , block_(CreateBlock(std::move(values)))
+{}
+/**
+ * Конструктор копирования, разделяет буфер other
+*/
+template <typename T, typename Alloc, typename Traits>
+CowVector<T, Alloc, Traits>::CowVector(const CowVector& other) noexcept
+    : alloc_(other.alloc_)
+    , block_(other.block_)
+{
+    if (block_ != nullptr) {
+        block_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+/**
+ * Конструктор перемещения
+*/
+template <typename T, typename Alloc, typename Traits>
+CowVector<T, Alloc, Traits>::CowVector(CowVector&& other) noexcept
+    : alloc_(other.alloc_)
+    , block_(std::exchange(other.block_, nullptr))
+{}
+
+/**
+ * Оператор копирующего присваивания, разделяет буфер other
+*/
+template <typename T, typename Alloc, typename Traits>
+CowVector<T, Alloc, Traits>& CowVector<T, Alloc, Traits>::operator=(const CowVector& other) noexcept {
+    CowVector copy(other);
+    Swap(copy);
+    return *this;
+}
+/**
+ * Оператор перемещающего присваивания
+*/
+template <typename T, typename Alloc, typename Traits>
+CowVector<T, Alloc, Traits>& CowVector<T, Alloc, Traits>::operator=(CowVector&& other) noexcept {
+    CowVector moved(std::move(other));
+    Swap(moved);
+    return *this;
+}
+
+/**
+ * Деструктор, освобождает буфер, если на него больше никто не ссылается
+*/
+template <typename T, typename Alloc, typename Traits>
+CowVector<T, Alloc, Traits>::~CowVector() noexcept {
+    ReleaseBlock();
+}
+
+/**
+ * Изменяет размер вектора. Из разделяемого буфера копируются только сохраняемые элементы
+*/
+template <typename T, typename Alloc, typename Traits>
+void CowVector<T, Alloc, Traits>::Resize(size_t new_size) {
+    const size_t size = Size();
+    if (new_size < size && IsShared()) {
+        DetachWithout(new_size, size);
+        return;
+    }
+    if (new_size != size) {
+        Mutable(new_size).Resize(new_size);
+    }
+}
+/**
+ * Резервирует память под указанное количество элементов вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+void CowVector<T, Alloc, Traits>::Reserve(size_t n) {
+    if (n > Capacity() || (n > Size() && IsShared())) {
+        Mutable(n).Reserve(n);
+    }
+}
+/**
+ * Удаляет все элементы вектора. Разделяемый буфер при этом не копируется
+*/
+template <typename T, typename Alloc, typename Traits>
+void CowVector<T, Alloc, Traits>::Clear() noexcept {
+    if (IsShared()) {
+        ReleaseBlock();
+    }
+    else if (block_ != nullptr) {
+        block_->values.Clear();
+    }
+}
+
+/**
+ * Передает аргументы конструктору типа T по forwarding-ссылке,
+ * полученный элемент добавляется в конец вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename... Types>
+T& CowVector<T, Alloc, Traits>::EmplaceBack(Types&&... args) {
+    // Аргументы могут ссылаться на элементы разделяемого буфера, поэтому
+    // он удерживается до создания нового элемента
+    const CowVector keep = IsShared() ? *this : CowVector(alloc_);
+    return Mutable(Size() + 1).EmplaceBack(std::forward<Types>(args)...);
+}
+/**
+ * Копирует или перемещает передаваемый элемент в конец вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename ValueType>
+void CowVector<T, Alloc, Traits>::PushBack(ValueType&& value) {
+    EmplaceBack(std::forward<ValueType>(value));
+}
+
+/**
+ * Передает аргументы конструктору типа T по forwarding-ссылке,
+ * вставляет полученный элемент в позицию pos, возвращает итератор на него
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename... Types>
+typename CowVector<T, Alloc, Traits>::iterator CowVector<T, Alloc, Traits>::Emplace(
+        const_iterator pos, Types&&... args) {
+    assert(cbegin() <= pos && pos <= cend());
+
+    const size_t index = pos - cbegin();
+    const CowVector keep = IsShared() ? *this : CowVector(alloc_);
+    VectorType& values = Mutable(Size() + 1);
+    return values.Emplace(values.cbegin() + index, std::forward<Types>(args)...);
+}
+/**
+ * Копирует или перемещает передаваемый элемент в позицию pos
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename ValueType>
+typename CowVector<T, Alloc, Traits>::iterator CowVector<T, Alloc, Traits>::Insert(
+        const_iterator pos, ValueType&& value) {
+    return Emplace(pos, std::forward<ValueType>(value));
+}
+
+/**
+ * Удаляет из вектора последний элемент
+*/
+template <typename T, typename Alloc, typename Traits>
+void CowVector<T, Alloc, Traits>::PopBack() {
+    assert(Size() > 0);
+    if (IsShared()) {
+        DetachWithout(Size() - 1, Size());
+        return;
+    }
+    block_->values.PopBack();
+}
+/**
+ * Удаляет элемент из заданной позиции. Если буфер разделяется, в новый буфер
+ * копируются остальные элементы, и сдвиг хвоста не требуется
+*/
+template <typename T, typename Alloc, typename Traits>
+typename CowVector<T, Alloc, Traits>::iterator CowVector<T, Alloc, Traits>::Erase(const_iterator pos) {
+    assert(cbegin() <= pos && pos < cend());
+
+    const size_t index = pos - cbegin();
+    if (IsShared()) {
+        DetachWithout(index, index + 1);
+    }
+    else {
+        block_->values.Erase(block_->values.cbegin() + index);
+    }
+    return block_ == nullptr ? nullptr : block_->values.begin() + index;
+}
+
+/**
+ * Возвращает размер вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+size_t CowVector<T, Alloc, Traits>::Size() const noexcept {
+    return block_ == nullptr ? 0 : block_->values.Size();
+}
+/**
+ * Возвращает вместимость вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+size_t CowVector<T, Alloc, Traits>::Capacity() const noexcept {
+    return block_ == nullptr ? 0 : block_->values.Capacity();
+}
+/**
+ * Проверяет, что буфер вектора разделяется с другими копиями
+*/
+template <typename T, typename Alloc, typename Traits>
+bool CowVector<T, Alloc, Traits>::IsShared() const noexcept {
+    return UseCount() > 1;
+}
+/**
+ * Возвращает количество векторов, разделяющих буфер, или 0 для вектора без буфера
+*/
+template <typename T, typename Alloc, typename Traits>
+size_t CowVector<T, Alloc, Traits>::UseCount() const noexcept {
+    // acquire синхронизируется с освобождением ссылок в других потоках:
+    // если ссылка осталась одна, изменения других владельцев уже видны
+    return block_ == nullptr ? 0 : block_->refs.load(std::memory_order_acquire);
+}
+
+/**
+ * Константная ссылка на элемент вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+const T& CowVector<T, Alloc, Traits>::operator[](size_t index) const noexcept {
+    assert(index < Size());
+    return block_->values[index];
+}
+/**
+ * Ссылка на элемент вектора, отделяет разделяемый буфер
+*/
+template <typename T, typename Alloc, typename Traits>
+T& CowVector<T, Alloc, Traits>::operator[](size_t index) {
+    assert(index < Size());
+    return Mutable(0)[index];
+}
+
+/**
+ * Возвращает итератор на начало вектора, отделяет разделяемый буфер
+*/
+template <typename T, typename Alloc, typename Traits>
+typename CowVector<T, Alloc, Traits>::iterator CowVector<T, Alloc, Traits>::begin() {
+    return Data();
+}
+/**
+ * Возвращает итератор на конец вектора, отделяет разделяемый буфер
+*/
+template <typename T, typename Alloc, typename Traits>
+typename CowVector<T, Alloc, Traits>::iterator CowVector<T, Alloc, Traits>::end() {
+    return Data() + Size();
+}
+/**
+ * Возвращает константный итератор на начало вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+typename CowVector<T, Alloc, Traits>::const_iterator CowVector<T, Alloc, Traits>::begin() const noexcept {
+    return Data();
+}
+/**
+ * Возвращает константный итератор на конец вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+typename CowVector<T, Alloc, Traits>::const_iterator CowVector<T, Alloc, Traits>::end() const noexcept {
+    return Data() + Size();
+}
+/**
+ * Возвращает константный итератор на начало вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+typename CowVector<T, Alloc, Traits>::const_iterator CowVector<T, Alloc, Traits>::cbegin() const noexcept {
+    return begin();
+}
+/**
+ * Возвращает константный итератор на конец вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+typename CowVector<T, Alloc, Traits>::const_iterator CowVector<T, Alloc, Traits>::cend() const noexcept {
+    return end();
+}
+
+/**
+ * Возвращает указатель на первый элемент вектора, отделяет разделяемый буфер
+*/
+template <typename T, typename Alloc, typename Traits>
+T* CowVector<T, Alloc, Traits>::Data() {
+    return block_ == nullptr ? nullptr : Mutable(0).Data();
+}
+template <typename T, typename Alloc, typename Traits>
+const T* CowVector<T, Alloc, Traits>::Data() const noexcept {
+    return block_ == nullptr ? nullptr : block_->values.Data();
+}
+
+/**
+ * Возвращает независимую копию элементов в виде Vector
+*/
+template <typename T, typename Alloc, typename Traits>
+typename CowVector<T, Alloc, Traits>::VectorType CowVector<T, Alloc, Traits>::ToVector() const {
+    return block_ == nullptr ? VectorType(alloc_) : VectorType(block_->values, alloc_);
+}
+
+/**
+ * Обменивает содержимое векторов
+*/
+template <typename T, typename Alloc, typename Traits>
+void CowVector<T, Alloc, Traits>::Swap(CowVector& other) noexcept {
+    std::swap(alloc_, other.alloc_);
+    std::swap(block_, other.block_);
+}
+
+/**
+ * Возвращает копию аллокатора вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+Alloc CowVector<T, Alloc, Traits>::GetAllocator() const noexcept {
+    return alloc_;
+}
+
+/**
+ * Создает буфер с единственной ссылкой, передавая аргументы конструктору вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename... Args>
+typename CowVector<T, Alloc, Traits>::Block* CowVector<T, Alloc, Traits>::CreateBlock(Args&&... args) const {
+    BlockAlloc alloc(alloc_);
+    Block* block = BlockTraits::allocate(alloc, 1);
+    try {
+        new (block) Block(std::forward<Args>(args)...);
+    }
+    catch (...) {
+        BlockTraits::deallocate(alloc, block, 1);
+        throw;
+    }
+    return block;
+}
+/**
+ * Освобождает ссылку на буфер, разрушая его вместе с элементами, если ссылка была последней
+*/
+template <typename T, typename Alloc, typename Traits>
+void CowVector<T, Alloc, Traits>::ReleaseBlock() noexcept {
+    Block* block = std::exchange(block_, nullptr);
+    if (block == nullptr || block->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    BlockAlloc alloc(alloc_);
+    std::destroy_at(block);
+    BlockTraits::deallocate(alloc, block, 1);
+}
+
+/**
+ * Возвращает вектор, которым этот объект владеет единолично. Разделяемый буфер копируется
+ * в новый с вместимостью не меньше capacity; при исключении вектор остается прежним
+*/
+template <typename T, typename Alloc, typename Traits>
+typename CowVector<T, Alloc, Traits>::VectorType& CowVector<T, Alloc, Traits>::Mutable(size_t capacity) {
+    if (block_ == nullptr) {
+        block_ = CreateBlock(alloc_);
+    }
+    else if (IsShared()) {
+        const VectorType& shared = block_->values;
+        VectorType values(alloc_);
+        values.Reserve(std::max(capacity, shared.Size()));
+        values.AppendRange(shared.begin(), shared.end());
+        Block* copy = CreateBlock(std::move(values));
+        ReleaseBlock();
+        block_ = copy;
+    }
+    return block_->values;
+}
+/**
+ * Заменяет разделяемый буфер копией без элементов [first, last)
+*/
+template <typename T, typename Alloc, typename Traits>
+void CowVector<T, Alloc, Traits>::DetachWithout(size_t first, size_t last) {
+    const VectorType& shared = block_->values;
+    const size_t size = shared.Size() - (last - first);
+    if (size == 0) {
+        ReleaseBlock();
+        return;
+    }
+
+    VectorType values(alloc_);
+    values.Reserve(size);
+    values.AppendRange(shared.begin(), shared.begin() + first);
+    values.AppendRange(shared.begin() + last, shared.end());
+    Block* copy = CreateBlock(std::move(values));
+    ReleaseBlock();
+    block_ = copy;
+}
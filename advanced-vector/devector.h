@@ -0,0 +1,633 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Вектор со свободным местом с обеих сторон буфера: элементы занимают ячейки
+ * [front_, front_ + size_) блока RawMemory. Добавление и удаление в начале выполняются
+ * за амортизированное O(1), вставка и удаление в середине сдвигают более короткую
+ * из двух частей. Когда заканчивается место с одной стороны, а буфер заполнен не больше
+ * чем наполовину, элементы перецентрируются без расширения буфера, поэтому очередь
+ * со скользящим окном не растет бесконечно. Тривиально перемещаемые элементы
+ * перецентрируются на месте, остальные - переносом в новый буфер той же вместимости
+*/
+template <typename T, typename Alloc = std::allocator<T>, typename Traits = DefaultVectorTraits>
+class Devector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+        "Devector<T, Alloc> requires Alloc::value_type to be T");
+
+    Devector() noexcept(noexcept(Alloc()));
+    explicit Devector(const Alloc& alloc) noexcept;
+    explicit Devector(size_t size, const Alloc& alloc = Alloc());
+    Devector(const Devector& other);
+    Devector(Devector&& other) noexcept;
+
+    Devector& operator=(const Devector& other);
+    Devector& operator=(Devector&& other) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value
+        || AllocTraits::is_always_equal::value);
+
+    ~Devector() noexcept;
+
+    void Resize(size_t new_size);
+    void Reserve(size_t n);
+    void ReserveFront(size_t n);
+    void Clear() noexcept;
+
+    template <typename... Types>
+    T& EmplaceBack(Types&&... args);
+    template <typename ValueType>
+    void PushBack(ValueType&& value);
+    template <typename... Types>
+    T& EmplaceFront(Types&&... args);
+    template <typename ValueType>
+    void PushFront(ValueType&& value);
+
+    template <typename... Types>
+    iterator Emplace(const_iterator pos, Types&&... args);
+    template <typename ValueType>
+    iterator Insert(const_iterator pos, ValueType&& value);
+
+    void PopBack() noexcept;
+    void PopFront() noexcept;
+    iterator Erase(const_iterator pos);
+
+    size_t Size() const noexcept;
+    size_t Capacity() const noexcept;
+    size_t FrontCapacity() const noexcept;
+    size_t BackCapacity() const noexcept;
+
+    const T& operator[](size_t index) const noexcept;
+    T& operator[](size_t index) noexcept;
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    T* Data() noexcept;
+    const T* Data() const noexcept;
+
+    void Swap(Devector& other) noexcept;
+
+    Alloc GetAllocator() const noexcept;
+
+private:
+    RawMemory<T, Alloc> data_; // Буфер со свободным местом с обеих сторон
+    size_t front_ = 0; // Количество свободных ячеек перед первым элементом
+    size_t size_ = 0; // Размер вектора
+
+    size_t NextCapacity(size_t required) const noexcept;
+    void Relocate(size_t new_capacity, size_t new_front);
+
+    template <typename... Types>
+    void InsertWithoutRoom(size_t index, Types&&... args);
+    template <typename... Types>
+    void ShiftFrontAndInsert(size_t index, Types&&... args);
+    template <typename... Types>
+    void ShiftBackAndInsert(size_t index, Types&&... args);
+};
+
+/**
+ * Конструктор по умолчанию
+*/
+template <typename T, typename Alloc, typename Traits>
+Devector<T, Alloc, Traits>::Devector() noexcept(noexcept(Alloc()))
+    : data_()
+{}
+/**
+ * Конструктор, создает пустой вектор, использующий заданный аллокатор
+*/
+template <typename T, typename Alloc, typename Traits>
+Devector<T, Alloc, Traits>::Devector(const Alloc& alloc) noexcept
+    : data_(alloc)
+{}
+/**
+ * Конструктор, создает вектор заданного размера без свободного места по краям
+*/
+template <typename T, typename Alloc, typename Traits>
+Devector<T, Alloc, Traits>::Devector(size_t size, const Alloc& alloc)
+    : data_(size, alloc)
+    , size_(size)
+{
+    std::uninitialized_value_construct_n(data_.GetAddress(), size_);
+}
+/**
+ * Конструктор, создает копию передаваемого вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+Devector<T, Alloc, Traits>::Devector(const Devector& other)
+    : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator()))
+    , size_(other.size_)
+{
+    std::uninitialized_copy_n(other.begin(), size_, data_.GetAddress());
+}
+/**
+ * Конструктор перемещения
+*/
+template <typename T, typename Alloc, typename Traits>
+Devector<T, Alloc, Traits>::Devector(Devector&& other) noexcept
+    : data_(std::move(other.data_))
+    , front_(std::exchange(other.front_, 0))
+    , size_(std::exchange(other.size_, 0))
+{}
+
+/**
+ * Оператор копирующего присваивания, применяет идиому copy-and-swap
+*/
+template <typename T, typename Alloc, typename Traits>
+Devector<T, Alloc, Traits>& Devector<T, Alloc, Traits>::operator=(const Devector& other) {
+    if (this != &other) {
+        Devector copy(other);
+        Swap(copy);
+    }
+    return *this;
+}
+/**
+ * Оператор перемещающего присваивания
+*/
+template <typename T, typename Alloc, typename Traits>
+Devector<T, Alloc, Traits>& Devector<T, Alloc, Traits>::operator=(Devector&& other) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value
+        || AllocTraits::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+
+    Clear();
+    // Если аллокаторы не распространяются при перемещении и различны - память other
+    // не может быть освобождена текущим аллокатором, поэтому перемещаем элементы поштучно
+    if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+            && !AllocTraits::is_always_equal::value) {
+        if (data_.GetAllocator() != other.data_.GetAllocator()) {
+            Reserve(other.size_);
+            detail::MoveElements(other.begin(), other.size_, begin());
+            size_ = std::exchange(other.size_, 0);
+            return *this;
+        }
+    }
+
+    data_ = std::move(other.data_);
+    front_ = std::exchange(other.front_, 0);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+}
+
+/**
+ * Деструктор, вызывает деструкторы хранящихся в векторе объектов
+*/
+template <typename T, typename Alloc, typename Traits>
+Devector<T, Alloc, Traits>::~Devector() noexcept {
+    std::destroy_n(begin(), size_);
+}
+
+/**
+ * Изменяет размер вектора, элементы добавляются и удаляются в конце
+*/
+template <typename T, typename Alloc, typename Traits>
+void Devector<T, Alloc, Traits>::Resize(size_t new_size) {
+    if (size_ > new_size) {
+        std::destroy_n(begin() + new_size, size_ - new_size);
+    }
+    else {
+        Reserve(new_size);
+        std::uninitialized_value_construct_n(end(), new_size - size_);
+    }
+    size_ = new_size;
+}
+/**
+ * Гарантирует, что n элементов поместятся в вектор при добавлении только в конец
+*/
+template <typename T, typename Alloc, typename Traits>
+void Devector<T, Alloc, Traits>::Reserve(size_t n) {
+    if (n > size_ + BackCapacity()) {
+        Relocate(front_ + std::max(n, size_), front_);
+    }
+}
+/**
+ * Гарантирует, что n элементов поместятся в вектор при добавлении только в начало
+*/
+template <typename T, typename Alloc, typename Traits>
+void Devector<T, Alloc, Traits>::ReserveFront(size_t n) {
+    if (n > size_ + front_) {
+        const size_t new_front = n - size_;
+        Relocate(new_front + size_ + BackCapacity(), new_front);
+    }
+}
+/**
+ * Удаляет все элементы вектора, сохраняя его вместимость
+*/
+template <typename T, typename Alloc, typename Traits>
+void Devector<T, Alloc, Traits>::Clear() noexcept {
+    std::destroy_n(begin(), size_);
+    size_ = 0;
+}
+
+/**
+ * Передает аргументы конструктору типа T по forwarding-ссылке,
+ * полученный элемент добавляется в конец вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename... Types>
+T& Devector<T, Alloc, Traits>::EmplaceBack(Types&&... args) {
+    if (BackCapacity() != 0) {
+        new (end()) T(std::forward<Types>(args)...);
+        ++size_;
+    }
+    else {
+        InsertWithoutRoom(size_, std::forward<Types>(args)...);
+    }
+    return begin()[size_ - 1];
+}
+/**
+ * Копирует или перемещает передаваемый элемент в конец вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename ValueType>
+void Devector<T, Alloc, Traits>::PushBack(ValueType&& value) {
+    EmplaceBack(std::forward<ValueType>(value));
+}
+/**
+ * Передает аргументы конструктору типа T по forwarding-ссылке,
+ * полученный элемент добавляется в начало вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename... Types>
+T& Devector<T, Alloc, Traits>::EmplaceFront(Types&&... args) {
+    if (front_ != 0) {
+        new (begin() - 1) T(std::forward<Types>(args)...);
+        --front_;
+        ++size_;
+    }
+    else {
+        InsertWithoutRoom(0, std::forward<Types>(args)...);
+    }
+    return *begin();
+}
+/**
+ * Копирует или перемещает передаваемый элемент в начало вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename ValueType>
+void Devector<T, Alloc, Traits>::PushFront(ValueType&& value) {
+    EmplaceFront(std::forward<ValueType>(value));
+}
+
+/**
+ * Передает аргументы конструктору типа T по forwarding-ссылке,
+ * вставляет полученный элемент в позицию pos, возвращает итератор на него.
+ * Сдвигается более короткая часть вектора, если с ее стороны есть место
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename... Types>
+typename Devector<T, Alloc, Traits>::iterator Devector<T, Alloc, Traits>::Emplace(
+        const_iterator pos, Types&&... args) {
+    assert(cbegin() <= pos && pos <= cend());
+
+    const size_t index = pos - cbegin();
+    if (index == size_) {
+        return std::addressof(EmplaceBack(std::forward<Types>(args)...));
+    }
+    if (index == 0) {
+        return std::addressof(EmplaceFront(std::forward<Types>(args)...));
+    }
+
+    const bool front_is_shorter = index < size_ - index;
+    if (front_ != 0 && (front_is_shorter || BackCapacity() == 0)) {
+        ShiftFrontAndInsert(index, std::forward<Types>(args)...);
+    }
+    else if (BackCapacity() != 0) {
+        ShiftBackAndInsert(index, std::forward<Types>(args)...);
+    }
+    else {
+        InsertWithoutRoom(index, std::forward<Types>(args)...);
+    }
+    return begin() + index;
+}
+/**
+ * Копирует или перемещает передаваемый элемент в позицию pos
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename ValueType>
+typename Devector<T, Alloc, Traits>::iterator Devector<T, Alloc, Traits>::Insert(
+        const_iterator pos, ValueType&& value) {
+    return Emplace(pos, std::forward<ValueType>(value));
+}
+
+/**
+ * Удаляет из вектора последний элемент
+*/
+template <typename T, typename Alloc, typename Traits>
+void Devector<T, Alloc, Traits>::PopBack() noexcept {
+    assert(size_ > 0);
+    std::destroy_at(begin() + (--size_));
+}
+/**
+ * Удаляет из вектора первый элемент
+*/
+template <typename T, typename Alloc, typename Traits>
+void Devector<T, Alloc, Traits>::PopFront() noexcept {
+    assert(size_ > 0);
+    std::destroy_at(begin());
+    ++front_;
+    --size_;
+}
+/**
+ * Удаляет элемент из заданной позиции, сдвигая более короткую часть вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+typename Devector<T, Alloc, Traits>::iterator Devector<T, Alloc, Traits>::Erase(const_iterator pos) {
+    assert(cbegin() <= pos && pos < cend());
+
+    const size_t index = pos - cbegin();
+    T* first = begin();
+    // Элементы перед index сдвигаются на один вправо
+    if (index < size_ - index - 1) {
+        if constexpr (IsTriviallyRelocatable_v<T>) {
+            std::destroy_at(first + index);
+            std::memmove(static_cast<void*>(first + 1), static_cast<const void*>(first), index * sizeof(T));
+        }
+        else {
+            std::move_backward(first, first + index, first + (index + 1));
+            std::destroy_at(first);
+        }
+        ++front_;
+    }
+    // Элементы после index сдвигаются на один влево
+    else {
+        if constexpr (IsTriviallyRelocatable_v<T>) {
+            std::destroy_at(first + index);
+            std::memmove(static_cast<void*>(first + index), static_cast<const void*>(first + (index + 1)),
+                (size_ - index - 1) * sizeof(T));
+        }
+        else {
+            std::move(first + (index + 1), end(), first + index);
+            std::destroy_at(end() - 1);
+        }
+    }
+    --size_;
+    return begin() + index;
+}
+
+/**
+ * Возвращает размер вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+size_t Devector<T, Alloc, Traits>::Size() const noexcept {
+    return size_;
+}
+/**
+ * Возвращает вместимость буфера вместе со свободным местом с обеих сторон
+*/
+template <typename T, typename Alloc, typename Traits>
+size_t Devector<T, Alloc, Traits>::Capacity() const noexcept {
+    return data_.Capacity();
+}
+/**
+ * Возвращает количество свободных ячеек перед первым элементом
+*/
+template <typename T, typename Alloc, typename Traits>
+size_t Devector<T, Alloc, Traits>::FrontCapacity() const noexcept {
+    return front_;
+}
+/**
+ * Возвращает количество свободных ячеек после последнего элемента
+*/
+template <typename T, typename Alloc, typename Traits>
+size_t Devector<T, Alloc, Traits>::BackCapacity() const noexcept {
+    return data_.Capacity() - front_ - size_;
+}
+
+/**
+ * Константная ссылка на элемент вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+const T& Devector<T, Alloc, Traits>::operator[](size_t index) const noexcept {
+    assert(index < size_);
+    return data_[front_ + index];
+}
+/**
+ * Ссылка на элемент вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+T& Devector<T, Alloc, Traits>::operator[](size_t index) noexcept {
+    assert(index < size_);
+    return data_[front_ + index];
+}
+
+/**
+ * Возвращает итератор на начало вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+typename Devector<T, Alloc, Traits>::iterator Devector<T, Alloc, Traits>::begin() noexcept {
+    return data_.GetAddress() + front_;
+}
+/**
+ * Возвращает итератор на конец вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+typename Devector<T, Alloc, Traits>::iterator Devector<T, Alloc, Traits>::end() noexcept {
+    return begin() + size_;
+}
+/**
+ * Возвращает константный итератор на начало вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+typename Devector<T, Alloc, Traits>::const_iterator Devector<T, Alloc, Traits>::begin() const noexcept {
+    return data_.GetAddress() + front_;
+}
+/**
+ * Возвращает константный итератор на конец вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+typename Devector<T, Alloc, Traits>::const_iterator Devector<T, Alloc, Traits>::end() const noexcept {
+    return begin() + size_;
+}
+/**
+ * Возвращает константный итератор на начало вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+typename Devector<T, Alloc, Traits>::const_iterator Devector<T, Alloc, Traits>::cbegin() const noexcept {
+    return begin();
+}
+/**
+ * Возвращает константный итератор на конец вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+typename Devector<T, Alloc, Traits>::const_iterator Devector<T, Alloc, Traits>::cend() const noexcept {
+    return end();
+}
+
+/**
+ * Возвращает указатель на первый элемент вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+T* Devector<T, Alloc, Traits>::Data() noexcept {
+    return begin();
+}
+template <typename T, typename Alloc, typename Traits>
+const T* Devector<T, Alloc, Traits>::Data() const noexcept {
+    return begin();
+}
+
+/**
+ * Обменивает содержимое векторов
+*/
+template <typename T, typename Alloc, typename Traits>
+void Devector<T, Alloc, Traits>::Swap(Devector& other) noexcept {
+    data_.Swap(other.data_);
+    std::swap(front_, other.front_);
+    std::swap(size_, other.size_);
+}
+
+/**
+ * Возвращает копию аллокатора вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+Alloc Devector<T, Alloc, Traits>::GetAllocator() const noexcept {
+    return data_.GetAllocator();
+}
+
+/**
+ * Возвращает вместимость, до которой следует расширить вектор,
+ * чтобы в нем поместилось required элементов
+*/
+template <typename T, typename Alloc, typename Traits>
+size_t Devector<T, Alloc, Traits>::NextCapacity(size_t required) const noexcept {
+    return Traits::GrowthPolicy::NextCapacity(Capacity(), required, sizeof(T));
+}
+/**
+ * Переносит элементы в новый буфер вместимостью new_capacity, оставляя перед ними new_front ячеек
+*/
+template <typename T, typename Alloc, typename Traits>
+void Devector<T, Alloc, Traits>::Relocate(size_t new_capacity, size_t new_front) {
+    assert(new_front + size_ <= new_capacity);
+
+    detail::CheckCopyFallback<Traits, T>();
+    RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+    detail::MoveElements(begin(), size_, new_data + new_front);
+    data_.Swap(new_data);
+    front_ = new_front;
+}
+
+/**
+ * Вставляет элемент в позицию index, когда с нужной стороны нет места. Если буфер заполнен
+ * не больше чем наполовину, элементы перецентрируются в нем же, иначе переносятся
+ * в расширенный буфер. Свободное место делится между сторонами поровну
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename... Types>
+void Devector<T, Alloc, Traits>::InsertWithoutRoom(size_t index, Types&&... args) {
+    const bool recenter = Capacity() != 0 && size_ <= Capacity() / 2;
+    const size_t new_capacity = recenter ? Capacity() : NextCapacity(size_ + 1);
+    const size_t new_front = (new_capacity - size_ - 1) / 2;
+
+    // Тривиально перемещаемые объекты сдвигаются внутри буфера побайтово, а новый элемент
+    // создается заранее, пока аргументы могут ссылаться на элементы вектора
+    if constexpr (IsTriviallyRelocatable_v<T>) {
+        if (recenter) {
+            alignas(T) unsigned char buffer[sizeof(T)];
+            new (buffer) T(std::forward<Types>(args)...);
+            T* first = begin();
+            T* to = data_ + new_front;
+            const auto move_prefix = [&] {
+                std::memmove(static_cast<void*>(to), static_cast<const void*>(first), index * sizeof(T));
+            };
+            const auto move_suffix = [&] {
+                std::memmove(static_cast<void*>(to + (index + 1)), static_cast<const void*>(first + index),
+                    (size_ - index) * sizeof(T));
+            };
+            // Первой сдвигается часть, место назначения которой не перекрывает исходную другой части
+            if (to < first) {
+                move_prefix();
+                move_suffix();
+            }
+            else {
+                move_suffix();
+                move_prefix();
+            }
+            std::memcpy(static_cast<void*>(to + index), static_cast<const void*>(buffer), sizeof(T));
+            front_ = new_front;
+            ++size_;
+            return;
+        }
+    }
+
+    detail::CheckCopyFallback<Traits, T>();
+    RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+    T* to = new_data + new_front;
+    new (to + index) T(std::forward<Types>(args)...);
+    try {
+        detail::MoveElementsWithGap(begin(), size_, index, to);
+    }
+    catch (...) {
+        std::destroy_at(to + index);
+        throw;
+    }
+    data_.Swap(new_data);
+    front_ = new_front;
+    ++size_;
+}
+/**
+ * Сдвигает элементы [0, index) на одну ячейку влево и вставляет элемент в позицию index
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename... Types>
+void Devector<T, Alloc, Traits>::ShiftFrontAndInsert(size_t index, Types&&... args) {
+    assert(front_ != 0 && index != 0);
+
+    T* first = begin();
+    if constexpr (IsTriviallyRelocatable_v<T>) {
+        alignas(T) unsigned char buffer[sizeof(T)];
+        new (buffer) T(std::forward<Types>(args)...);
+        std::memmove(static_cast<void*>(first - 1), static_cast<const void*>(first), index * sizeof(T));
+        std::memcpy(static_cast<void*>(first + (index - 1)), static_cast<const void*>(buffer), sizeof(T));
+    }
+    else {
+        T temp(std::forward<Types>(args)...);
+        new (first - 1) T(std::move(*first));
+        std::move(first + 1, first + index, first);
+        first[index - 1] = std::move(temp);
+    }
+    --front_;
+    ++size_;
+}
+/**
+ * Сдвигает элементы [index, size_) на одну ячейку вправо и вставляет элемент в позицию index
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename... Types>
+void Devector<T, Alloc, Traits>::ShiftBackAndInsert(size_t index, Types&&... args) {
+    assert(BackCapacity() != 0 && index < size_);
+
+    T* first = begin();
+    if constexpr (IsTriviallyRelocatable_v<T>) {
+        alignas(T) unsigned char buffer[sizeof(T)];
+        new (buffer) T(std::forward<Types>(args)...);
+        std::memmove(static_cast<void*>(first + (index + 1)), static_cast<const void*>(first + index),
+            (size_ - index) * sizeof(T));
+        std::memcpy(static_cast<void*>(first + index), static_cast<const void*>(buffer), sizeof(T));
+    }
+    else {
+        T temp(std::forward<Types>(args)...);
+        new (end()) T(std::move(first[size_ - 1]));
+        std::move_backward(first + index, end() - 1, end());
+        first[index] = std::move(temp);
+    }
+    ++size_;
+}
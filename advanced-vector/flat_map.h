@@ -0,0 +1,540 @@
+#pragma once
+#include "flat_set.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Упорядоченный словарь на двух параллельных векторах: отсортированных ключей и значений.
+ * Бинарный поиск проходит только по плотному массиву ключей, значения не засоряют кеш.
+ * Итератор разыменовывается в пару ссылок std::pair<const K&, V&>. Вставка и удаление
+ * сдвигают хвосты обоих векторов, InsertRange сливает отсортированный диапазон за один проход
+*/
+template <typename K, typename V, typename Compare = std::less<K>>
+class FlatMap {
+    template <bool IsConst>
+    class BasicIterator;
+
+public:
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+    using KeyVector = Vector<K>;
+    using ValueVector = Vector<V>;
+
+    FlatMap() = default;
+    explicit FlatMap(const Compare& comp);
+    template <typename InputIt>
+    FlatMap(InputIt first, InputIt last, const Compare& comp = Compare());
+
+    template <typename... Types>
+    std::pair<iterator, bool> Emplace(const K& key, Types&&... args);
+    template <typename... Types>
+    std::pair<iterator, bool> Emplace(K&& key, Types&&... args);
+    template <typename Value>
+    std::pair<iterator, bool> InsertOrAssign(const K& key, Value&& value);
+    template <typename InputIt>
+    void InsertRange(InputIt first, InputIt last);
+
+    V& operator[](const K& key);
+    V& At(const K& key);
+    const V& At(const K& key) const;
+
+    size_t Erase(const K& key);
+    iterator Erase(const_iterator pos);
+
+    void Reserve(size_t n);
+    void Clear() noexcept;
+
+    size_t Size() const noexcept;
+    size_t Capacity() const noexcept;
+
+    iterator Find(const K& key);
+    const_iterator Find(const K& key) const;
+    bool Contains(const K& key) const;
+    iterator LowerBound(const K& key);
+    const_iterator LowerBound(const K& key) const;
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    const KeyVector& Keys() const noexcept;
+    const ValueVector& Values() const noexcept;
+
+    void Swap(FlatMap& other) noexcept;
+
+private:
+    KeyVector keys_;     // Ключи в порядке возрастания
+    ValueVector values_; // values_[i] соответствует keys_[i]
+    Compare comp_;
+
+    size_t LowerBoundIndex(const K& key) const;
+    size_t FindIndex(const K& key) const;
+    template <typename Key, typename... Types>
+    std::pair<iterator, bool> EmplaceUnique(Key&& key, Types&&... args);
+    iterator MakeIterator(size_t index) noexcept;
+    const_iterator MakeIterator(size_t index) const noexcept;
+};
+
+/**
+ * Итератор произвольного доступа по парам ключ-значение. Хранит указатели
+ * на ключ и значение в параллельных векторах
+*/
+template <typename K, typename V, typename Compare>
+template <bool IsConst>
+class FlatMap<K, V, Compare>::BasicIterator {
+    friend class FlatMap;
+    friend class BasicIterator<!IsConst>;
+
+    using MappedType = std::conditional_t<IsConst, const V, V>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::pair<K, V>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const K&, MappedType&>;
+
+    // Указатель на временную пару ссылок для operator->
+    struct pointer {
+        reference ref;
+        const reference* operator->() const noexcept {
+            return &ref;
+        }
+    };
+
+    BasicIterator() = default;
+    template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+    BasicIterator(const BasicIterator<OtherConst>& other) noexcept
+        : key_(other.key_)
+        , value_(other.value_)
+    {}
+
+    reference operator*() const noexcept {
+        return {*key_, *value_};
+    }
+    pointer operator->() const noexcept {
+        return {**this};
+    }
+    reference operator[](difference_type n) const noexcept {
+        return {key_[n], value_[n]};
+    }
+
+    const K& Key() const noexcept {
+        return *key_;
+    }
+    MappedType& Value() const noexcept {
+        return *value_;
+    }
+
+    BasicIterator& operator++() noexcept {
+        ++key_;
+        ++value_;
+        return *this;
+    }
+    BasicIterator operator++(int) noexcept {
+        BasicIterator old = *this;
+        ++*this;
+        return old;
+    }
+    BasicIterator& operator--() noexcept {
+        --key_;
+        --value_;
+        return *this;
+    }
+    BasicIterator operator--(int) noexcept {
+        BasicIterator old = *this;
+        --*this;
+        return old;
+    }
+    BasicIterator& operator+=(difference_type n) noexcept {
+        key_ += n;
+        value_ += n;
+        return *this;
+    }
+    BasicIterator& operator-=(difference_type n) noexcept {
+        return *this += -n;
+    }
+    friend BasicIterator operator+(BasicIterator it, difference_type n) noexcept {
+        return it += n;
+    }
+    friend BasicIterator operator+(difference_type n, BasicIterator it) noexcept {
+        return it += n;
+    }
+    friend BasicIterator operator-(BasicIterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+    friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.key_ - rhs.key_;
+    }
+
+    friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.key_ == rhs.key_;
+    }
+    friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.key_ != rhs.key_;
+    }
+    friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.key_ < rhs.key_;
+    }
+    friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.key_ > rhs.key_;
+    }
+    friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.key_ <= rhs.key_;
+    }
+    friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.key_ >= rhs.key_;
+    }
+
+private:
+    const K* key_ = nullptr;
+    MappedType* value_ = nullptr;
+
+    BasicIterator(const K* key, MappedType* value) noexcept
+        : key_(key)
+        , value_(value)
+    {}
+};
+
+/**
+ * Конструктор, создает пустой словарь с заданным сравнением
+*/
+template <typename K, typename V, typename Compare>
+FlatMap<K, V, Compare>::FlatMap(const Compare& comp)
+    : comp_(comp)
+{}
+/**
+ * Конструктор, создает словарь из пар диапазона [first, last)
+*/
+template <typename K, typename V, typename Compare>
+template <typename InputIt>
+FlatMap<K, V, Compare>::FlatMap(InputIt first, InputIt last, const Compare& comp)
+    : comp_(comp)
+{
+    InsertRange(first, last);
+}
+
+/**
+ * Конструирует значение из аргументов, если ключа еще нет; существующее значение
+ * не изменяется. Возвращает итератор на элемент и признак вставки
+*/
+template <typename K, typename V, typename Compare>
+template <typename... Types>
+std::pair<typename FlatMap<K, V, Compare>::iterator, bool> FlatMap<K, V, Compare>::Emplace(const K& key, Types&&... args) {
+    return EmplaceUnique(key, std::forward<Types>(args)...);
+}
+/**
+ * Перемещает ключ и конструирует значение из аргументов, если ключа еще нет
+*/
+template <typename K, typename V, typename Compare>
+template <typename... Types>
+std::pair<typename FlatMap<K, V, Compare>::iterator, bool> FlatMap<K, V, Compare>::Emplace(K&& key, Types&&... args) {
+    return EmplaceUnique(std::move(key), std::forward<Types>(args)...);
+}
+/**
+ * Вставляет значение или присваивает его существующему элементу
+*/
+template <typename K, typename V, typename Compare>
+template <typename Value>
+std::pair<typename FlatMap<K, V, Compare>::iterator, bool> FlatMap<K, V, Compare>::InsertOrAssign(const K& key, Value&& value) {
+    const size_t index = FindIndex(key);
+    if (index != keys_.Size()) {
+        values_[index] = std::forward<Value>(value);
+        return {MakeIterator(index), false};
+    }
+    return EmplaceUnique(key, std::forward<Value>(value));
+}
+/**
+ * Вставляет пары диапазона [first, last) за O(n + m log m): сортирует их и сливает
+ * с хранимыми элементами в новые векторы. Из равных ключей остается хранившийся ранее
+ * или первый в диапазоне. При исключении словарь не изменяется
+*/
+template <typename K, typename V, typename Compare>
+template <typename InputIt>
+void FlatMap<K, V, Compare>::InsertRange(InputIt first, InputIt last) {
+    Vector<std::pair<K, V>> incoming;
+    incoming.AppendRange(first, last);
+    if (incoming.Size() == 0) {
+        return;
+    }
+    std::stable_sort(incoming.begin(), incoming.end(), [this](const auto& lhs, const auto& rhs) {
+        return comp_(lhs.first, rhs.first);
+    });
+
+    KeyVector keys;
+    ValueVector values;
+    keys.Reserve(keys_.Size() + incoming.Size());
+    values.Reserve(keys_.Size() + incoming.Size());
+    size_t old_index = 0;
+    auto it = incoming.begin();
+    while (old_index < keys_.Size() || it != incoming.end()) {
+        if (it == incoming.end() || (old_index < keys_.Size() && !comp_(it->first, keys_[old_index]))) {
+            // Хранимый ключ идет раньше или совпадает с добавляемым
+            if (it != incoming.end() && !comp_(keys_[old_index], it->first)) {
+                ++it;
+                continue;
+            }
+            keys.EmplaceBack(std::move_if_noexcept(keys_[old_index]));
+            values.EmplaceBack(std::move_if_noexcept(values_[old_index]));
+            ++old_index;
+        } else {
+            // Повторы внутри диапазона отбрасываются, первый из них уже добавлен
+            if (keys.Size() == 0 || comp_(keys[keys.Size() - 1], it->first)) {
+                keys.EmplaceBack(std::move(it->first));
+                values.EmplaceBack(std::move(it->second));
+            }
+            ++it;
+        }
+    }
+    keys_.Swap(keys);
+    values_.Swap(values);
+}
+
+/**
+ * Возвращает значение по ключу, вставляя значение по умолчанию при его отсутствии
+*/
+template <typename K, typename V, typename Compare>
+V& FlatMap<K, V, Compare>::operator[](const K& key) {
+    return EmplaceUnique(key).first.Value();
+}
+/**
+ * Возвращает значение по ключу, выбрасывает std::out_of_range при его отсутствии
+*/
+template <typename K, typename V, typename Compare>
+V& FlatMap<K, V, Compare>::At(const K& key) {
+    const size_t index = FindIndex(key);
+    if (index == keys_.Size()) {
+        throw std::out_of_range("FlatMap::At: key not found");
+    }
+    return values_[index];
+}
+/**
+ * Возвращает значение по ключу, выбрасывает std::out_of_range при его отсутствии
+*/
+template <typename K, typename V, typename Compare>
+const V& FlatMap<K, V, Compare>::At(const K& key) const {
+    const size_t index = FindIndex(key);
+    if (index == keys_.Size()) {
+        throw std::out_of_range("FlatMap::At: key not found");
+    }
+    return values_[index];
+}
+
+/**
+ * Удаляет элемент по ключу, возвращает количество удаленных элементов
+*/
+template <typename K, typename V, typename Compare>
+size_t FlatMap<K, V, Compare>::Erase(const K& key) {
+    const size_t index = FindIndex(key);
+    if (index == keys_.Size()) {
+        return 0;
+    }
+    Erase(MakeIterator(index));
+    return 1;
+}
+/**
+ * Удаляет элемент в позиции pos, возвращает итератор на следующий элемент
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::iterator FlatMap<K, V, Compare>::Erase(const_iterator pos) {
+    const size_t index = pos.key_ - keys_.Data();
+    // EraseRange сдвигает хвосты тривиально перемещаемых типов одним memmove
+    keys_.EraseRange(pos.key_, pos.key_ + 1);
+    values_.EraseRange(pos.value_, pos.value_ + 1);
+    return MakeIterator(index);
+}
+
+/**
+ * Резервирует место под n элементов в обоих векторах
+*/
+template <typename K, typename V, typename Compare>
+void FlatMap<K, V, Compare>::Reserve(size_t n) {
+    keys_.Reserve(n);
+    values_.Reserve(n);
+}
+/**
+ * Удаляет все элементы
+*/
+template <typename K, typename V, typename Compare>
+void FlatMap<K, V, Compare>::Clear() noexcept {
+    keys_.Clear();
+    values_.Clear();
+}
+
+/**
+ * Возвращает количество элементов
+*/
+template <typename K, typename V, typename Compare>
+size_t FlatMap<K, V, Compare>::Size() const noexcept {
+    return keys_.Size();
+}
+/**
+ * Возвращает количество элементов, вмещающихся без перераспределения
+*/
+template <typename K, typename V, typename Compare>
+size_t FlatMap<K, V, Compare>::Capacity() const noexcept {
+    return std::min(keys_.Capacity(), values_.Capacity());
+}
+
+/**
+ * Возвращает итератор на элемент с ключом key или end()
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::iterator FlatMap<K, V, Compare>::Find(const K& key) {
+    return MakeIterator(FindIndex(key));
+}
+/**
+ * Возвращает итератор на элемент с ключом key или end()
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::const_iterator FlatMap<K, V, Compare>::Find(const K& key) const {
+    return MakeIterator(FindIndex(key));
+}
+/**
+ * Проверяет наличие ключа
+*/
+template <typename K, typename V, typename Compare>
+bool FlatMap<K, V, Compare>::Contains(const K& key) const {
+    return FindIndex(key) != keys_.Size();
+}
+/**
+ * Возвращает итератор на первый элемент с ключом, не меньшим key
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::iterator FlatMap<K, V, Compare>::LowerBound(const K& key) {
+    return MakeIterator(LowerBoundIndex(key));
+}
+/**
+ * Возвращает итератор на первый элемент с ключом, не меньшим key
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::const_iterator FlatMap<K, V, Compare>::LowerBound(const K& key) const {
+    return MakeIterator(LowerBoundIndex(key));
+}
+
+/**
+ * Возвращает итератор на элемент с наименьшим ключом
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::iterator FlatMap<K, V, Compare>::begin() noexcept {
+    return MakeIterator(0);
+}
+/**
+ * Возвращает итератор на конец словаря
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::iterator FlatMap<K, V, Compare>::end() noexcept {
+    return MakeIterator(keys_.Size());
+}
+/**
+ * Возвращает итератор на элемент с наименьшим ключом
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::const_iterator FlatMap<K, V, Compare>::begin() const noexcept {
+    return MakeIterator(0);
+}
+/**
+ * Возвращает итератор на конец словаря
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::const_iterator FlatMap<K, V, Compare>::end() const noexcept {
+    return MakeIterator(keys_.Size());
+}
+/**
+ * Возвращает итератор на элемент с наименьшим ключом
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::const_iterator FlatMap<K, V, Compare>::cbegin() const noexcept {
+    return begin();
+}
+/**
+ * Возвращает итератор на конец словаря
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::const_iterator FlatMap<K, V, Compare>::cend() const noexcept {
+    return end();
+}
+
+/**
+ * Возвращает отсортированный вектор ключей
+*/
+template <typename K, typename V, typename Compare>
+const typename FlatMap<K, V, Compare>::KeyVector& FlatMap<K, V, Compare>::Keys() const noexcept {
+    return keys_;
+}
+/**
+ * Возвращает вектор значений в порядке ключей
+*/
+template <typename K, typename V, typename Compare>
+const typename FlatMap<K, V, Compare>::ValueVector& FlatMap<K, V, Compare>::Values() const noexcept {
+    return values_;
+}
+
+/**
+ * Обменивает содержимое словарей
+*/
+template <typename K, typename V, typename Compare>
+void FlatMap<K, V, Compare>::Swap(FlatMap& other) noexcept {
+    keys_.Swap(other.keys_);
+    values_.Swap(other.values_);
+    std::swap(comp_, other.comp_);
+}
+
+/**
+ * Возвращает индекс первого ключа, не меньшего key
+*/
+template <typename K, typename V, typename Compare>
+size_t FlatMap<K, V, Compare>::LowerBoundIndex(const K& key) const {
+    return detail::FlatLowerBound(keys_.Data(), keys_.Size(), key, comp_) - keys_.Data();
+}
+/**
+ * Возвращает индекс ключа, равного key, или Size()
+*/
+template <typename K, typename V, typename Compare>
+size_t FlatMap<K, V, Compare>::FindIndex(const K& key) const {
+    const size_t index = LowerBoundIndex(key);
+    return index != keys_.Size() && !comp_(key, keys_[index]) ? index : keys_.Size();
+}
+/**
+ * Вставляет элемент в позицию, найденную бинарным поиском. Значение вставляется первым:
+ * если затем выбросит вставка ключа, значение удаляется и векторы остаются согласованными
+*/
+template <typename K, typename V, typename Compare>
+template <typename Key, typename... Types>
+std::pair<typename FlatMap<K, V, Compare>::iterator, bool> FlatMap<K, V, Compare>::EmplaceUnique(Key&& key, Types&&... args) {
+    const size_t index = LowerBoundIndex(key);
+    if (index != keys_.Size() && !comp_(key, keys_[index])) {
+        return {MakeIterator(index), false};
+    }
+    values_.Emplace(values_.begin() + index, std::forward<Types>(args)...);
+    try {
+        keys_.Emplace(keys_.begin() + index, std::forward<Key>(key));
+    } catch (...) {
+        values_.Erase(values_.begin() + index);
+        throw;
+    }
+    return {MakeIterator(index), true};
+}
+/**
+ * Возвращает итератор на элемент с индексом index
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::iterator FlatMap<K, V, Compare>::MakeIterator(size_t index) noexcept {
+    return iterator(keys_.Data() + index, values_.Data() + index);
+}
+/**
+ * Возвращает итератор на элемент с индексом index
+*/
+template <typename K, typename V, typename Compare>
+typename FlatMap<K, V, Compare>::const_iterator FlatMap<K, V, Compare>::MakeIterator(size_t index) const noexcept {
+    return const_iterator(keys_.Data() + index, values_.Data() + index);
+}
@@ -0,0 +1,295 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace detail {
+
+/**
+ * Бинарный поиск без ветвлений: возвращает первую позицию в отсортированном массиве
+ * из size элементов, элемент в которой не меньше key. Условный переход заменяется
+ * выбором адреса, поэтому неудачные предсказания не сбрасывают конвейер
+*/
+template <typename K, typename Key, typename Compare>
+const K* FlatLowerBound(const K* data, size_t size, const Key& key, const Compare& comp) {
+    if (size == 0) {
+        return data;
+    }
+    const K* base = data;
+    while (size > 1) {
+        const size_t half = size / 2;
+        base = comp(base[half], key) ? base + half : base;
+        size -= half;
+    }
+    return base + (comp(*base, key) ? 1 : 0);
+}
+
+} // namespace detail
+
+/**
+ * Упорядоченное множество на непрерывном хранилище Vector. Поиск — бинарный по плотному
+ * массиву ключей, вставка и удаление сдвигают хвост (для тривиально перемещаемых ключей
+ * одним memmove). InsertRange сортирует добавляемые ключи и сливает их с хранимыми
+ * за один проход вместо серии сдвигов
+*/
+template <typename K, typename Compare = std::less<K>, typename Alloc = std::allocator<K>>
+class FlatSet {
+public:
+    using iterator = const K*;
+    using const_iterator = const K*;
+    using VectorType = Vector<K, Alloc>;
+
+    FlatSet() = default;
+    explicit FlatSet(const Compare& comp);
+    template <typename InputIt>
+    FlatSet(InputIt first, InputIt last, const Compare& comp = Compare());
+
+    template <typename... Types>
+    std::pair<iterator, bool> Emplace(Types&&... args);
+    std::pair<iterator, bool> Insert(const K& key);
+    std::pair<iterator, bool> Insert(K&& key);
+    template <typename InputIt>
+    void InsertRange(InputIt first, InputIt last);
+
+    size_t Erase(const K& key);
+    iterator Erase(const_iterator pos);
+
+    void Reserve(size_t n);
+    void ShrinkToFit();
+    void Clear() noexcept;
+
+    size_t Size() const noexcept;
+    size_t Capacity() const noexcept;
+
+    iterator Find(const K& key) const;
+    bool Contains(const K& key) const;
+    iterator LowerBound(const K& key) const;
+    iterator UpperBound(const K& key) const;
+
+    iterator begin() const noexcept;
+    iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    const VectorType& Keys() const noexcept;
+
+    void Swap(FlatSet& other) noexcept;
+
+private:
+    VectorType keys_; // Ключи в порядке возрастания
+    Compare comp_;
+
+    template <typename Key>
+    std::pair<iterator, bool> InsertUnique(Key&& key);
+};
+
+/**
+ * Конструктор, создает пустое множество с заданным сравнением
+*/
+template <typename K, typename Compare, typename Alloc>
+FlatSet<K, Compare, Alloc>::FlatSet(const Compare& comp)
+    : comp_(comp)
+{}
+/**
+ * Конструктор, создает множество из ключей диапазона [first, last)
+*/
+template <typename K, typename Compare, typename Alloc>
+template <typename InputIt>
+FlatSet<K, Compare, Alloc>::FlatSet(InputIt first, InputIt last, const Compare& comp)
+    : comp_(comp)
+{
+    InsertRange(first, last);
+}
+
+/**
+ * Конструирует ключ из аргументов и вставляет его, если такого ключа еще нет.
+ * Возвращает итератор на ключ и признак вставки
+*/
+template <typename K, typename Compare, typename Alloc>
+template <typename... Types>
+std::pair<typename FlatSet<K, Compare, Alloc>::iterator, bool> FlatSet<K, Compare, Alloc>::Emplace(Types&&... args) {
+    return InsertUnique(K(std::forward<Types>(args)...));
+}
+/**
+ * Вставляет копию ключа, если такого ключа еще нет
+*/
+template <typename K, typename Compare, typename Alloc>
+std::pair<typename FlatSet<K, Compare, Alloc>::iterator, bool> FlatSet<K, Compare, Alloc>::Insert(const K& key) {
+    return InsertUnique(key);
+}
+/**
+ * Перемещает ключ в множество, если такого ключа еще нет
+*/
+template <typename K, typename Compare, typename Alloc>
+std::pair<typename FlatSet<K, Compare, Alloc>::iterator, bool> FlatSet<K, Compare, Alloc>::Insert(K&& key) {
+    return InsertUnique(std::move(key));
+}
+/**
+ * Вставляет ключи диапазона [first, last): дописывает их в конец, сортирует добавленную
+ * часть и сливает ее с хранимыми ключами за O(n + m log m). Из равных ключей остается
+ * хранившийся ранее или первый в диапазоне
+*/
+template <typename K, typename Compare, typename Alloc>
+template <typename InputIt>
+void FlatSet<K, Compare, Alloc>::InsertRange(InputIt first, InputIt last) {
+    const size_t old_size = keys_.Size();
+    keys_.AppendRange(first, last);
+    K* middle = keys_.begin() + old_size;
+    // Устойчивые сортировка и слияние сохраняют первым из равных ключей тот, что должен остаться
+    std::stable_sort(middle, keys_.end(), comp_);
+    std::inplace_merge(keys_.begin(), middle, keys_.end(), comp_);
+    K* unique_end = std::unique(keys_.begin(), keys_.end(), [this](const K& lhs, const K& rhs) {
+        return !comp_(lhs, rhs);
+    });
+    keys_.EraseRange(unique_end, keys_.end());
+}
+
+/**
+ * Удаляет ключ, возвращает количество удаленных ключей
+*/
+template <typename K, typename Compare, typename Alloc>
+size_t FlatSet<K, Compare, Alloc>::Erase(const K& key) {
+    const_iterator pos = Find(key);
+    if (pos == end()) {
+        return 0;
+    }
+    Erase(pos);
+    return 1;
+}
+/**
+ * Удаляет ключ в позиции pos, возвращает итератор на следующий ключ
+*/
+template <typename K, typename Compare, typename Alloc>
+typename FlatSet<K, Compare, Alloc>::iterator FlatSet<K, Compare, Alloc>::Erase(const_iterator pos) {
+    // EraseRange сдвигает хвост тривиально перемещаемых ключей одним memmove
+    return keys_.EraseRange(pos, pos + 1);
+}
+
+/**
+ * Резервирует место под n ключей
+*/
+template <typename K, typename Compare, typename Alloc>
+void FlatSet<K, Compare, Alloc>::Reserve(size_t n) {
+    keys_.Reserve(n);
+}
+/**
+ * Уменьшает вместимость до количества ключей
+*/
+template <typename K, typename Compare, typename Alloc>
+void FlatSet<K, Compare, Alloc>::ShrinkToFit() {
+    keys_.ShrinkToFit();
+}
+/**
+ * Удаляет все ключи
+*/
+template <typename K, typename Compare, typename Alloc>
+void FlatSet<K, Compare, Alloc>::Clear() noexcept {
+    keys_.Clear();
+}
+
+/**
+ * Возвращает количество ключей
+*/
+template <typename K, typename Compare, typename Alloc>
+size_t FlatSet<K, Compare, Alloc>::Size() const noexcept {
+    return keys_.Size();
+}
+/**
+ * Возвращает вместимость хранилища
+*/
+template <typename K, typename Compare, typename Alloc>
+size_t FlatSet<K, Compare, Alloc>::Capacity() const noexcept {
+    return keys_.Capacity();
+}
+
+/**
+ * Возвращает итератор на ключ, равный key, или end()
+*/
+template <typename K, typename Compare, typename Alloc>
+typename FlatSet<K, Compare, Alloc>::iterator FlatSet<K, Compare, Alloc>::Find(const K& key) const {
+    const_iterator pos = LowerBound(key);
+    return pos != end() && !comp_(key, *pos) ? pos : end();
+}
+/**
+ * Проверяет наличие ключа
+*/
+template <typename K, typename Compare, typename Alloc>
+bool FlatSet<K, Compare, Alloc>::Contains(const K& key) const {
+    return Find(key) != end();
+}
+/**
+ * Возвращает итератор на первый ключ, не меньший key
+*/
+template <typename K, typename Compare, typename Alloc>
+typename FlatSet<K, Compare, Alloc>::iterator FlatSet<K, Compare, Alloc>::LowerBound(const K& key) const {
+    return detail::FlatLowerBound(keys_.Data(), keys_.Size(), key, comp_);
+}
+/**
+ * Возвращает итератор на первый ключ, больший key
+*/
+template <typename K, typename Compare, typename Alloc>
+typename FlatSet<K, Compare, Alloc>::iterator FlatSet<K, Compare, Alloc>::UpperBound(const K& key) const {
+    return std::upper_bound(begin(), end(), key, comp_);
+}
+
+/**
+ * Возвращает итератор на наименьший ключ
+*/
+template <typename K, typename Compare, typename Alloc>
+typename FlatSet<K, Compare, Alloc>::iterator FlatSet<K, Compare, Alloc>::begin() const noexcept {
+    return keys_.begin();
+}
+/**
+ * Возвращает итератор на конец множества
+*/
+template <typename K, typename Compare, typename Alloc>
+typename FlatSet<K, Compare, Alloc>::iterator FlatSet<K, Compare, Alloc>::end() const noexcept {
+    return keys_.end();
+}
+/**
+ * Возвращает итератор на наименьший ключ
+*/
+template <typename K, typename Compare, typename Alloc>
+typename FlatSet<K, Compare, Alloc>::const_iterator FlatSet<K, Compare, Alloc>::cbegin() const noexcept {
+    return keys_.cbegin();
+}
+/**
+ * Возвращает итератор на конец множества
+*/
+template <typename K, typename Compare, typename Alloc>
+typename FlatSet<K, Compare, Alloc>::const_iterator FlatSet<K, Compare, Alloc>::cend() const noexcept {
+    return keys_.cend();
+}
+
+/**
+ * Возвращает отсортированный вектор ключей
+*/
+template <typename K, typename Compare, typename Alloc>
+const typename FlatSet<K, Compare, Alloc>::VectorType& FlatSet<K, Compare, Alloc>::Keys() const noexcept {
+    return keys_;
+}
+
+/**
+ * Обменивает содержимое множеств
+*/
+template <typename K, typename Compare, typename Alloc>
+void FlatSet<K, Compare, Alloc>::Swap(FlatSet& other) noexcept {
+    keys_.Swap(other.keys_);
+    std::swap(comp_, other.comp_);
+}
+
+/**
+ * Вставляет ключ в позицию, найденную бинарным поиском
+*/
+template <typename K, typename Compare, typename Alloc>
+template <typename Key>
+std::pair<typename FlatSet<K, Compare, Alloc>::iterator, bool> FlatSet<K, Compare, Alloc>::InsertUnique(Key&& key) {
+    const_iterator pos = LowerBound(key);
+    if (pos != end() && !comp_(key, *pos)) {
+        return {pos, false};
+    }
+    return {keys_.Emplace(pos, std::forward<Key>(key)), true};
+}
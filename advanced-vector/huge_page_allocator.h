@@ -0,0 +1,226 @@
+#pragma once
+#include "vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#include <sys/mman.h>
+
+inline constexpr size_t HUGE_PAGE_2M = size_t{1} << 21;
+inline constexpr size_t HUGE_PAGE_1G = size_t{1} << 30;
+
+// Размер служебного заголовка перед буфером крупного блока, он же выравнивание данных
+inline constexpr size_t HUGE_PAGE_HEADER_SIZE = 64;
+
+/**
+ * Способ, которым HugePageAllocator получил блок памяти
+*/
+enum class HugePageKind {
+    NONE,           // Блок меньше порога, выделен operator new
+    HUGETLB,        // Зарезервированные большие страницы (MAP_HUGETLB)
+    TRANSPARENT,    // Обычное отображение с MADV_HUGEPAGE
+    FALLBACK,       // Большие страницы недоступны, блок выделен operator new
+};
+
+/**
+ * Аллокатор, выделяющий блоки не меньше Threshold байт отображением, выровненным
+ * по большой странице PageSize. Сначала пробуются зарезервированные страницы MAP_HUGETLB,
+ * затем прозрачные большие страницы (MADV_HUGEPAGE); если недоступны и они, блок выделяется
+ * operator new. Перед крупным блоком хранится заголовок со способом выделения.
+ * Чтобы байты до конца последней страницы не пропадали, используйте HugePageGrowth
+*/
+template <typename T, size_t Threshold = HUGE_PAGE_2M, size_t PageSize = HUGE_PAGE_2M>
+struct HugePageAllocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static_assert((PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two");
+    static_assert(alignof(T) <= HUGE_PAGE_HEADER_SIZE, "HugePageAllocator does not support such alignment");
+
+    static constexpr size_t ALIGNMENT = HUGE_PAGE_HEADER_SIZE;
+    static constexpr size_t THRESHOLD = Threshold;
+    static constexpr size_t PAGE_SIZE = PageSize;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, Threshold, PageSize>;
+    };
+
+    HugePageAllocator() = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, Threshold, PageSize>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n);
+    void deallocate(T* buf, size_t n) noexcept;
+
+    static HugePageKind Kind(const T* buf, size_t n) noexcept;
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U, Threshold, PageSize>& /*other*/) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U, Threshold, PageSize>& /*other*/) const noexcept {
+        return false;
+    }
+
+private:
+    struct BlockHeader {
+        HugePageKind kind;
+        size_t mapped_bytes;
+    };
+    static_assert(sizeof(BlockHeader) <= HUGE_PAGE_HEADER_SIZE);
+
+    static void* MapHugeTlb(size_t bytes) noexcept;
+    static void* MapTransparent(size_t bytes) noexcept;
+    static BlockHeader* HeaderOf(const T* buf) noexcept;
+};
+
+/**
+ * Политика-адаптер роста для HugePageAllocator: начиная с Threshold байт дополняет
+ * вместимость, вычисленную политикой Base, до целого числа больших страниц с учетом заголовка
+*/
+template <typename Base, size_t Threshold = HUGE_PAGE_2M, size_t PageSize = HUGE_PAGE_2M>
+struct HugePageGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t base = Base::NextCapacity(capacity, required, element_size);
+        if (base > (std::numeric_limits<size_t>::max() - PageSize - HUGE_PAGE_HEADER_SIZE) / element_size) {
+            return base;
+        }
+        const size_t bytes = base * element_size;
+        if (bytes < Threshold) {
+            return base;
+        }
+        const size_t mapped = (bytes + HUGE_PAGE_HEADER_SIZE + PageSize - 1) / PageSize * PageSize;
+        return (mapped - HUGE_PAGE_HEADER_SIZE) / element_size;
+    }
+};
+
+struct HugePageTraits : DefaultVectorTraits {
+    using GrowthPolicy = HugePageGrowth<DoublingGrowth>;
+};
+
+template <typename T>
+using HugePageVector = Vector<T, HugePageAllocator<T>, HugePageTraits>;
+
+/**
+ * Выделяет память под n элементов
+*/
+template <typename T, size_t Threshold, size_t PageSize>
+T* HugePageAllocator<T, Threshold, PageSize>::allocate(size_t n) {
+    if (n > (std::numeric_limits<size_t>::max() - PageSize - HUGE_PAGE_HEADER_SIZE) / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+    const size_t bytes = n * sizeof(T);
+    if (bytes < Threshold) {
+        return static_cast<T*>(operator new(bytes, std::align_val_t{ALIGNMENT}));
+    }
+
+    const size_t mapped = (bytes + HUGE_PAGE_HEADER_SIZE + PageSize - 1) / PageSize * PageSize;
+    BlockHeader header{HugePageKind::HUGETLB, mapped};
+    void* base = MapHugeTlb(mapped);
+    if (base == nullptr) {
+        header.kind = HugePageKind::TRANSPARENT;
+        base = MapTransparent(mapped);
+    }
+    if (base == nullptr) {
+        header = BlockHeader{HugePageKind::FALLBACK, 0};
+        base = operator new(bytes + HUGE_PAGE_HEADER_SIZE, std::align_val_t{ALIGNMENT});
+    }
+    new (base) BlockHeader(header);
+    return reinterpret_cast<T*>(static_cast<char*>(base) + HUGE_PAGE_HEADER_SIZE);
+}
+/**
+ * Освобождает блок buf, выделенный под n элементов
+*/
+template <typename T, size_t Threshold, size_t PageSize>
+void HugePageAllocator<T, Threshold, PageSize>::deallocate(T* buf, size_t n) noexcept {
+    if (n * sizeof(T) < Threshold) {
+        operator delete(buf, std::align_val_t{ALIGNMENT});
+        return;
+    }
+    BlockHeader* header = HeaderOf(buf);
+    if (header->kind == HugePageKind::FALLBACK) {
+        operator delete(header, std::align_val_t{ALIGNMENT});
+    } else {
+        ::munmap(header, header->mapped_bytes);
+    }
+}
+/**
+ * Возвращает способ, которым был выделен блок buf под n элементов
+*/
+template <typename T, size_t Threshold, size_t PageSize>
+HugePageKind HugePageAllocator<T, Threshold, PageSize>::Kind(const T* buf, size_t n) noexcept {
+    if (n * sizeof(T) < Threshold) {
+        return HugePageKind::NONE;
+    }
+    return HeaderOf(buf)->kind;
+}
+
+/**
+ * Отображает bytes байт зарезервированными большими страницами. Возвращает nullptr,
+ * если такие страницы не настроены в системе
+*/
+template <typename T, size_t Threshold, size_t PageSize>
+void* HugePageAllocator<T, Threshold, PageSize>::MapHugeTlb([[maybe_unused]] size_t bytes) noexcept {
+#ifdef MAP_HUGETLB
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+    // Размер страницы передается его двоичным логарифмом
+    if constexpr (PageSize == HUGE_PAGE_2M) {
+        flags |= 21 << MAP_HUGE_SHIFT;
+    } else if constexpr (PageSize == HUGE_PAGE_1G) {
+        flags |= 30 << MAP_HUGE_SHIFT;
+    }
+#endif
+    void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+    return base == MAP_FAILED ? nullptr : base;
+#else
+    return nullptr;
+#endif
+}
+/**
+ * Отображает bytes байт по адресу, выровненному на PageSize, и просит ядро использовать
+ * для него прозрачные большие страницы. Возвращает nullptr, если они отключены
+*/
+template <typename T, size_t Threshold, size_t PageSize>
+void* HugePageAllocator<T, Threshold, PageSize>::MapTransparent([[maybe_unused]] size_t bytes) noexcept {
+#ifdef MADV_HUGEPAGE
+    // Отображаем с запасом в одну страницу и обрезаем края до выровненного участка
+    const size_t reserved = bytes + PageSize;
+    void* raw = ::mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    const auto begin = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t aligned = (begin + PageSize - 1) / PageSize * PageSize;
+    if (aligned != begin) {
+        ::munmap(raw, aligned - begin);
+    }
+    const std::uintptr_t tail = begin + reserved - (aligned + bytes);
+    if (tail != 0) {
+        ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    }
+
+    void* base = reinterpret_cast<void*>(aligned);
+    if (::madvise(base, bytes, MADV_HUGEPAGE) != 0) {
+        ::munmap(base, bytes);
+        return nullptr;
+    }
+    return base;
+#else
+    return nullptr;
+#endif
+}
+/**
+ * Возвращает заголовок крупного блока
+*/
+template <typename T, size_t Threshold, size_t PageSize>
+typename HugePageAllocator<T, Threshold, PageSize>::BlockHeader*
+HugePageAllocator<T, Threshold, PageSize>::HeaderOf(const T* buf) noexcept {
+    return reinterpret_cast<BlockHeader*>(
+        const_cast<char*>(reinterpret_cast<const char*>(buf)) - HUGE_PAGE_HEADER_SIZE);
+}
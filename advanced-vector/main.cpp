@@ -1,8 +1,39 @@
 #include "vector.h"
+#include "block_cache.h"
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "devector.h"
+#include "flat_map.h"
+#include "flat_set.h"
+#include "huge_page_allocator.h"
+#include "mapped_file.h"
+#include "parallel_execution.h"
+#include "segmented_vector.h"
+#include "simd_algorithms.h"
+#include "small_vector.h"
+#include "soa_vector.h"
+#include "static_vector.h"
+#include "test_utils.h"
+#include "vector_coroutine.h"
+#include "vector_io.h"
+#include "vector_stats.h"
 
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -25,99 +56,174 @@ struct TestObj {
     uint32_t cookie = DEFAULT_COOKIE;
 };
 
-struct Obj {
-    Obj() {
-        if (default_construction_throw_countdown > 0) {
-            if (--default_construction_throw_countdown == 0) {
-                throw std::runtime_error("Oops");
-            }
-        }
-        ++num_default_constructed;
+// Тип, владеющий ресурсом, который можно безопасно переносить побайтово
+struct RelocatableObj {
+    RelocatableObj() = default;
+    explicit RelocatableObj(int id)
+        : value(std::make_unique<int>(id))  //
+    {
     }
 
-    explicit Obj(int id)
-        : id(id)  //
+    std::unique_ptr<int> value;
+};
+
+// Аллокатор с состоянием, отслеживающий количество невозвращенных блоков
+template <typename T>
+struct TrackingAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit TrackingAllocator(int* live_blocks) noexcept
+        : live_blocks(live_blocks)  //
     {
-        ++num_constructed_with_id;
     }
-
-    Obj(int id, std::string name)
-        : id(id)
-        , name(std::move(name))  //
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U>& other) noexcept
+        : live_blocks(other.live_blocks)  //
     {
-        ++num_constructed_with_id_and_name;
     }
 
-    Obj(const Obj& other)
-        : id(other.id)  //
-    {
-        if (other.throw_on_copy) {
-            throw std::runtime_error("Oops");
+    T* allocate(size_t n) {
+        ++*live_blocks;
+        return std::allocator<T>{}.allocate(n);
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        --*live_blocks;
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    bool operator==(const TrackingAllocator& other) const noexcept {
+        return live_blocks == other.live_blocks;
+    }
+    bool operator!=(const TrackingAllocator& other) const noexcept {
+        return !(*this == other);
+    }
+
+    int* live_blocks;
+};
+
+template <typename Growth>
+struct GrowthTraits : DefaultVectorTraits {
+    using GrowthPolicy = Growth;
+};
+
+struct ShrinkingTraits : DefaultVectorTraits {
+    using ShrinkPolicy = HysteresisShrink<4, 16>;
+};
+
+struct CountingTraits : DefaultVectorTraits {
+    using StatsPolicy = InstanceStats;
+};
+
+struct StatsTag {
+    static constexpr std::string_view NAME = "test";
+};
+
+struct RegisteredTraits : DefaultVectorTraits {
+    using StatsPolicy = RegisteredStats<StatsTag>;
+};
+
+// Разбиение на 4 части уже для 64 элементов, чтобы тесты проверяли параллельные ветки
+struct ParallelTraits : DefaultVectorTraits {
+    using ExecutionPolicy = ParallelExecution<16, 4>;
+};
+
+// Политика выполнения, считающая параллельные запуски; части выполняются последовательно
+struct CountingExecution {
+    static size_t ChunkCount(size_t count) noexcept {
+        return count >= 16 ? 2 : 1;
+    }
+    template <typename Task>
+    static void Run(size_t chunks, Task& task) noexcept {
+        ++num_runs;
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            task(chunk);
         }
-        ++num_copied;
     }
 
-    Obj(Obj&& other) noexcept
-        : id(other.id)  //
+    static inline int num_runs = 0;
+};
+
+struct CountingExecutionTraits : DefaultVectorTraits {
+    using ExecutionPolicy = CountingExecution;
+};
+
+template <typename Checks>
+struct CheckTraits : DefaultVectorTraits {
+    using CheckPolicy = Checks;
+};
+
+template <typename Policy>
+struct CopyFallbackTraits : DefaultVectorTraits {
+    using CopyFallbackPolicy = Policy;
+};
+
+// Порог больших страниц, при котором тесты не выделяют сотни мегабайт
+const size_t HUGE_PAGE_TEST_THRESHOLD = size_t{1} << 16;
+
+struct HugePageTestTraits : DefaultVectorTraits {
+    using GrowthPolicy = HugePageGrowth<DoublingGrowth, HUGE_PAGE_TEST_THRESHOLD>;
+};
+
+// Тип с потокобезопасными счетчиками для проверки параллельных операций.
+// Перемещение не noexcept, поэтому при переаллокации объекты копируются
+struct SharedObj {
+    SharedObj()
+        : id(num_constructed.fetch_add(1))
     {
-        ++num_moved;
+        if (id == throw_at) {
+            num_constructed.fetch_sub(1);
+            throw std::runtime_error("Oops");
+        }
+        ++num_alive;
     }
-
-    Obj& operator=(const Obj& other) {
-        if (this != &other) {
-            id = other.id;
-            name = other.name;
-            ++num_assigned;
+    SharedObj(const SharedObj& other)
+        : id(other.id)
+    {
+        if (other.id == throw_at) {
+            throw std::runtime_error("Oops");
         }
+        ++num_alive;
+    }
+    SharedObj(SharedObj&& other) noexcept(false)
+        : SharedObj(std::as_const(other))
+    {
+    }
+    SharedObj& operator=(const SharedObj& other) {
+        id = other.id;
         return *this;
     }
-
-    Obj& operator=(Obj&& other) noexcept {
+    SharedObj& operator=(SharedObj&& other) noexcept(false) {
         id = other.id;
-        name = std::move(other.name);
-        ++num_move_assigned;
         return *this;
     }
-
-    ~Obj() {
-        ++num_destroyed;
-        id = 0;
+    ~SharedObj() {
+        --num_alive;
     }
 
-    static int GetAliveObjectCount() {
-        return num_default_constructed + num_copied + num_moved + num_constructed_with_id
-            + num_constructed_with_id_and_name - num_destroyed;
-    }
+    int id = 0;
 
-    static void ResetCounters() {
-        default_construction_throw_countdown = 0;
-        num_default_constructed = 0;
-        num_copied = 0;
-        num_moved = 0;
-        num_destroyed = 0;
-        num_constructed_with_id = 0;
-        num_constructed_with_id_and_name = 0;
-        num_assigned = 0;
-        num_move_assigned = 0;
-    }
+    static inline std::atomic<int> num_constructed = 0;
+    static inline std::atomic<int> num_alive = 0;
+    static inline int throw_at = -1;
+};
 
-    bool throw_on_copy = false;
-    int id = 0;
-    std::string name;
-
-    static inline int default_construction_throw_countdown = 0;
-    static inline int num_default_constructed = 0;
-    static inline int num_constructed_with_id = 0;
-    static inline int num_constructed_with_id_and_name = 0;
-    static inline int num_copied = 0;
-    static inline int num_moved = 0;
-    static inline int num_destroyed = 0;
-    static inline int num_assigned = 0;
-    static inline int num_move_assigned = 0;
+// Тип, который при переаллокации копируется, так как его перемещение не noexcept
+struct ThrowingMoveObj {
+    ThrowingMoveObj() = default;
+    ThrowingMoveObj(const ThrowingMoveObj&) = default;
+    ThrowingMoveObj(ThrowingMoveObj&&) noexcept(false) {
+    }
+    std::string value;
 };
 
 }  // namespace
 
+template <>
+struct IsTriviallyRelocatable<RelocatableObj> : std::true_type {};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -558,84 +664,2202 @@ void Test6() {
     }
 }
 
-struct C {
-    C() noexcept {
-        ++def_ctor;
+void Test7() {
+    static_assert(IsTriviallyRelocatable_v<int>);
+    static_assert(IsTriviallyRelocatable_v<RelocatableObj>);
+    static_assert(!IsTriviallyRelocatable_v<Obj>);
+    static_assert(!IsTriviallyRelocatable_v<std::string>);
+
+    const size_t SIZE = 1000;
+    {
+        Vector<RelocatableObj> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        v.Reserve(SIZE * 4);
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() == SIZE * 4);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(*v[i].value == static_cast<int>(i));
+        }
+    }
+    {
+        Vector<RelocatableObj> v;
+        v.EmplaceBack(1);
+        v.EmplaceBack(3);
+        assert(v.Size() == v.Capacity());
+        // Вставка с реаллокацией переносит обе части вектора блоками памяти
+        auto* pos = v.Emplace(v.cbegin() + 1, 2);
+        assert(&*pos == &v[1]);
+        assert(v.Size() == 3);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(*v[i].value == static_cast<int>(i + 1));
+        }
+    }
+}
+
+void Test8() {
+    const size_t SIZE = 100;
+    {
+        alignas(std::max_align_t) char buffer[4096];
+        std::pmr::monotonic_buffer_resource resource(
+            buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        pmr::Vector<int> v(&resource);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        const char* first = reinterpret_cast<const char*>(&v[0]);
+        assert(first >= buffer && first < buffer + sizeof(buffer));
+        assert(v.GetAllocator().resource() == &resource);
+
+        // Копия получает ресурс по умолчанию, как и std::pmr::vector
+        pmr::Vector<int> v_copy(v);
+        assert(v_copy.GetAllocator().resource() == std::pmr::get_default_resource());
+        assert(v_copy[SIZE - 1] == static_cast<int>(SIZE - 1));
+
+        // polymorphic_allocator не распространяется при перемещении,
+        // поэтому элементы перемещаются поштучно в память приемника
+        pmr::Vector<int> v_other(std::pmr::new_delete_resource());
+        v_other = std::move(v);
+        assert(v_other.GetAllocator().resource() == std::pmr::new_delete_resource());
+        assert(v_other.Size() == SIZE);
+        assert(v_other[SIZE / 2] == static_cast<int>(SIZE / 2));
+        assert(v.Size() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        int live_a = 0;
+        int live_b = 0;
+        {
+            using Alloc = TrackingAllocator<Obj>;
+            Vector<Obj, Alloc> a(SIZE, Alloc(&live_a));
+            Vector<Obj, Alloc> b{Alloc(&live_b)};
+            b.PushBack(Obj{1});
+            assert(live_a == 1 && live_b == 1);
+
+            b = a;
+            assert(b.GetAllocator() == a.GetAllocator());
+            assert(live_a == 2 && live_b == 0);
+
+            Vector<Obj, Alloc> c{Alloc(&live_b)};
+            c.Reserve(SIZE);
+            c.Swap(a);
+            assert(c.GetAllocator() == Alloc(&live_a));
+            assert(a.GetAllocator() == Alloc(&live_b));
+            assert(c.Size() == SIZE);
+
+            a = std::move(c);
+            assert(a.GetAllocator() == Alloc(&live_a));
+            assert(live_b == 0);
+        }
+        assert(live_a == 0 && live_b == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test9() {
+    {
+        Vector<int, std::allocator<int>, GrowthTraits<GoldenGrowth>> v;
+        const size_t expected[] = {1, 2, 3, 4, 6, 9, 13, 19};
+        for (size_t capacity : expected) {
+            while (v.Size() < v.Capacity()) {
+                v.PushBack(0);
+            }
+            v.PushBack(0);
+            assert(v.Capacity() == capacity);
+        }
     }
-    C(const C& /*other*/) noexcept {
-        ++copy_ctor;
+    {
+        Vector<int, std::allocator<int>, GrowthTraits<GeometricGrowth<2, 1, 16>>> v;
+        v.PushBack(1);
+        assert(v.Capacity() == 16);
+        v.Insert(v.begin(), 0);
+        assert(v.Capacity() == 16);
+        assert(v[0] == 0 && v[1] == 1);
     }
-    C(C&& /*other*/) noexcept {
-        ++move_ctor;
+    {
+        Vector<double, std::allocator<double>, GrowthTraits<PageRoundedGrowth<DoublingGrowth>>> v;
+        v.PushBack(1.0);
+        assert(v.Capacity() == 4096 / sizeof(double));
+        v.Resize(600);
+        v.PushBack(2.0);
+        // 1200 элементов занимают 9600 байт, что округляется до трех страниц
+        assert(v.Capacity() == 3 * 4096 / sizeof(double));
     }
-    C& operator=(const C& other) noexcept {
-        if (this != &other) {
-            ++copy_assign;
+}
+
+void Test10() {
+    static_assert(HasReallocate_v<MallocAllocator<int>>);
+    static_assert(!HasReallocate_v<std::allocator<int>>);
+
+    const size_t SIZE = 100'000;
+    {
+        Vector<int, MallocAllocator<int>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        v.Reserve(SIZE * 4);
+        assert(v.Capacity() == SIZE * 4);
+        assert(v.Size() == SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == static_cast<int>(i));
         }
-        return *this;
     }
-    C& operator=(C&& /*other*/) noexcept {
-        ++move_assign;
-        return *this;
+    {
+        Vector<RelocatableObj, MallocAllocator<RelocatableObj>> v;
+        v.EmplaceBack(1);
+        // Аргумент, ссылающийся на элемент вектора, должен пережить расширение буфера
+        v.EmplaceBack(std::move(v[0]));
+        assert(v.Size() == 2);
+        assert(!v[0].value && *v[1].value == 1);
+    }
+    {
+        // Для типов, не являющихся тривиально перемещаемыми, используется обычный путь
+        Obj::ResetCounters();
+        Vector<Obj, MallocAllocator<Obj>> v(SIZE);
+        v.Reserve(SIZE * 2);
+        assert(Obj::num_moved == static_cast<int>(SIZE));
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
     }
-    ~C() {
-        ++dtor;
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test11() {
+    const size_t N = 4;
+    const int ID = 42;
+    {
+        AllocationStats::Reset();
+        SmallVector<int, N, CountingAllocator<int>> v;
+        for (size_t i = 0; i < N; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        assert(v.IsInline());
+        assert(v.Capacity() == N);
+        assert(AllocationStats::num_allocations == 0);
+
+        v.PushBack(static_cast<int>(N));
+        assert(!v.IsInline());
+        assert(v.Capacity() == N * 2);
+        assert(AllocationStats::num_allocations == 1);
+        for (size_t i = 0; i <= N; ++i) {
+            assert(v[i] == static_cast<int>(i));
+        }
     }
+    assert(AllocationStats::live_bytes == 0);
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, N> v(N);
+        auto* pos = v.Emplace(v.cbegin() + 1, ID, "Ivan");
+        assert(&*pos == &v[1]);
+        assert(v.Size() == N + 1);
+        assert(v[1].id == ID);
+        assert(Obj::num_moved == static_cast<int>(N));
+        assert(Obj::num_copied == 0);
 
-    static void Reset() {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
+        pos = v.Erase(v.cbegin() + 1);
+        assert(v.Size() == N);
+        assert(pos->id == 0);
+        v.PopBack();
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(N - 1));
     }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Копирование и перемещение как в малом буфере, так и в динамической памяти
+        Obj::ResetCounters();
+        SmallVector<Obj, N> small(N - 1);
+        SmallVector<Obj, N> large(N * 3);
+        small[0].id = ID;
+        large[N * 2].id = ID;
 
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
-};
+        SmallVector<Obj, N> small_copy(small);
+        assert(small_copy.IsInline() && small_copy[0].id == ID);
+        SmallVector<Obj, N> large_moved(std::move(large));
+        assert(large.Size() == 0 && large.IsInline());
+        assert(large_moved[N * 2].id == ID);
 
-void Dump() {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-         << ", Copy ctors: "sv << C::copy_ctor          //
-         << ", Move ctors: "sv << C::move_ctor          //
-         << ", Copy assignments: "sv << C::copy_assign  //
-         << ", Move assignments: "sv << C::move_assign  //
-         << ", Dtors: "sv << C::dtor << endl;
+        small_copy.Swap(large_moved);
+        assert(small_copy.Size() == N * 3 && small_copy[N * 2].id == ID);
+        assert(large_moved.Size() == N - 1 && large_moved[0].id == ID);
+
+        large_moved = small_copy;
+        assert(large_moved.Size() == N * 3 && !large_moved.IsInline());
+        small_copy = std::move(small);
+        assert(small_copy.Size() == N - 1 && small_copy[0].id == ID);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(N * 3 + N - 1));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Исключение при копировании не должно изменять исходный вектор
+        Obj::ResetCounters();
+        SmallVector<Obj, N> v(N * 2);
+        v[N].throw_on_copy = true;
+        try {
+            SmallVector<Obj, N> v_copy(v);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(N * 2));
+
+        Obj::default_construction_throw_countdown = 2;
+        try {
+            v.Resize(N * 4);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == N * 2);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(N * 2));
+    }
+    {
+        SmallVector<TestObj, 1> v(1);
+        v.PushBack(v[0]);
+        v.Insert(v.cbegin(), std::move(v[1]));
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+    }
 }
 
-void Benchmark() {
-    using namespace std;
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
+void Test12() {
+    const size_t SIZE = 10;
+    const size_t COUNT = 4;
+    {
+        Vector<int> v;
+        std::vector<int> src(SIZE);
+        std::iota(src.begin(), src.end(), 0);
+        v.AppendRange(src.begin(), src.end());
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+
+        const int extra[COUNT] = {100, 101, 102, 103};
+        auto pos = v.InsertRange(v.cbegin() + 2, std::begin(extra), std::end(extra));
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE + COUNT);
+        assert(v[1] == 1 && v[2] == 100 && v[5] == 103 && v[6] == 2 && v[SIZE + COUNT - 1] == 9);
+
+        pos = v.EraseRange(v.cbegin() + 2, v.cbegin() + 2 + COUNT);
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == static_cast<int>(i));
         }
-        Dump();
-    } catch (...) {
+
+        // Вставка без реаллокации сдвигает хвост одним блоком
+        const size_t capacity = v.Capacity();
+        v.EraseRange(v.cbegin(), v.cbegin() + COUNT);
+        v.InsertRange(v.cbegin() + 1, std::begin(extra), std::end(extra));
+        assert(v.Capacity() == capacity);
+        assert(v[0] == 4 && v[1] == 100 && v[5] == 5 && v[SIZE - 1] == 9);
+
+        std::istringstream input("7 8 9");
+        v.InsertRange(v.cbegin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert(v.Size() == SIZE + 3);
+        assert(v[0] == 4 && v[1] == 7 && v[3] == 9 && v[4] == 100);
     }
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+    {
+        // Сдвиг хвоста, длина которого больше и меньше вставляемого диапазона
+        Obj::ResetCounters();
+        Vector<Obj> src(COUNT);
+        for (size_t tail : {size_t{1}, COUNT * 2}) {
+            Vector<Obj> v(COUNT + tail);
+            v.Reserve(v.Size() + COUNT);
+            v[COUNT].id = 1;
+            const int old_copied = Obj::num_copied + Obj::num_assigned;
+            v.InsertRange(v.cbegin() + COUNT, src.begin(), src.end());
+            assert(v.Size() == COUNT * 2 + tail);
+            assert(v[COUNT * 2].id == 1);
+            assert(v[COUNT].id == 0);
+            assert(Obj::num_copied + Obj::num_assigned - old_copied == static_cast<int>(COUNT));
+        }
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(COUNT));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v[SIZE - 1].id = 1;
+        v.EraseRange(v.cbegin() + 1, v.cbegin() + 1 + COUNT);
+        assert(v.Size() == SIZE - COUNT);
+        assert(v[SIZE - COUNT - 1].id == 1);
+        assert(Obj::num_move_assigned == static_cast<int>(SIZE - COUNT - 1));
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE - COUNT));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> src(SIZE);
+        src[SIZE - 1].id = 1;
+        Vector<Obj> v(COUNT);
+        v.Assign(src.begin(), src.end());
+        assert(v.Size() == SIZE && v[SIZE - 1].id == 1);
+        v.Assign(src.begin(), src.begin() + COUNT);
+        assert(v.Size() == COUNT && v.Capacity() == SIZE);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE + COUNT));
+
+        // При исключении в процессе реаллокации исходный вектор не меняется
+        src[SIZE / 2].throw_on_copy = true;
+        Vector<Obj> other(1);
+        try {
+            other.InsertRange(other.cbegin(), src.begin(), src.end());
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(other.Size() == 1 && other.Capacity() == 1);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE + COUNT + 1));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test13() {
+    const size_t SIZE = 100;
+    {
+        Vector<double> v(SIZE, DEFAULT_INIT);
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        v.ResizeDefaultInit(SIZE * 2);
+        assert(v.Size() == SIZE * 2);
+        v.ResizeDefaultInit(SIZE / 2);
+        assert(v.Size() == SIZE / 2 && v.Capacity() == SIZE * 2);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE, DEFAULT_INIT);
+        v.ResizeDefaultInit(SIZE + 1);
+        assert(Obj::num_default_constructed == static_cast<int>(SIZE + 1));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<int> v(1);
+        v.ResizeAndOverwrite(SIZE, [](int* data, size_t n) {
+            for (size_t i = 1; i < n / 2; ++i) {
+                data[i] = static_cast<int>(i);
+            }
+            return n / 2;
+        });
+        assert(v.Size() == SIZE / 2);
+        assert(v[0] == 0 && v[SIZE / 2 - 1] == static_cast<int>(SIZE / 2 - 1));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        try {
+            v.ResizeAndOverwrite(SIZE * 2, [](Obj*, size_t) -> size_t {
+                throw std::runtime_error("Oops");
+            });
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
+    }
+}
+
+void Test14() {
+    const size_t SIZE = 1000;
+    {
+        Vector<float, AlignedAllocator<float, 64>> v;
+        static_assert(decltype(v)::ALIGNMENT == 64);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(1.0f);
+            assert(reinterpret_cast<std::uintptr_t>(v.Data()) % 64 == 0);
+        }
+
+        const float* data = v.AssumeAligned();
+        float sum = 0.0f;
+        for (size_t i = 0; i < v.Size(); ++i) {
+            sum += data[i];
+        }
+        assert(sum == static_cast<float>(SIZE));
+    }
+    {
+        struct alignas(64) CacheLine {
+            int value = 0;
+        };
+        Vector<CacheLine> v(SIZE);
+        static_assert(decltype(v)::ALIGNMENT == 64);
+        assert(reinterpret_cast<std::uintptr_t>(v.AssumeAligned()) % 64 == 0);
+        assert(v.Data() == &v[0]);
+    }
+}
+
+void Test15() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() == SIZE);
+        assert(Obj::GetAliveObjectCount() == 0);
+
+        v.Resize(SIZE / 2);
+        v.ShrinkToFit();
+        assert(v.Size() == SIZE / 2 && v.Capacity() == SIZE / 2);
+        assert(Obj::num_moved == static_cast<int>(SIZE / 2));
+
+        v.Release();
+        assert(v.Size() == 0 && v.Capacity() == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Vector<int, MallocAllocator<int>> v(SIZE);
+        v[SIZE / 2 - 1] = 1;
+        v.Resize(SIZE / 2);
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE / 2 && v[SIZE / 2 - 1] == 1);
+        v.Resize(0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+    }
+    {
+        Vector<int, std::allocator<int>, ShrinkingTraits> v;
+        for (size_t i = 0; i < SIZE * 10; ++i) {
+            v.PushBack(static_cast<int>(i));
         }
-        Dump();
-    } catch (...) {
+        assert(v.Capacity() == 1024);
+
+        // Вместимость уменьшается до удвоенного размера, когда размер падает ниже четверти
+        while (v.Size() > 256) {
+            v.PopBack();
+        }
+        assert(v.Capacity() == 1024);
+        v.PopBack();
+        assert(v.Size() == 255 && v.Capacity() == 510);
+        assert(v[254] == 254);
+
+        // Колебания размера около порога не приводят к переаллокациям
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(0);
+            v.PopBack();
+        }
+        assert(v.Capacity() == 510);
+
+        v.EraseRange(v.cbegin(), v.cend() - 1);
+        assert(v.Size() == 1 && v.Capacity() == 16);
+        assert(v[0] == 254);
+        v.Erase(v.cbegin());
+        assert(v.Capacity() == 16);
+    }
+}
+
+void Test16() {
+    // Отключенная статистика не увеличивает размер вектора
+    static_assert(sizeof(Vector<int>) == sizeof(RawMemory<int>) + sizeof(size_t));
+
+    const size_t SIZE = 100;
+    {
+        Vector<int, std::allocator<int>, CountingTraits> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        const VectorStats& stats = v.Stats();
+        assert(stats.allocations == 8 && stats.reallocations == 7);
+        assert(stats.allocated_bytes == 255 * sizeof(int));
+        assert(stats.moved_elements == 127 && stats.copied_elements == 0);
+        assert(stats.peak_capacity == 128);
+
+        // Статистика принадлежит объекту и не переносится при копировании
+        Vector<int, std::allocator<int>, CountingTraits> copy(v);
+        assert(copy.Stats().allocations == 1 && copy.Stats().peak_capacity == SIZE);
+        assert(v.Stats().allocations == 8);
+    }
+    {
+        Vector<ThrowingMoveObj, std::allocator<ThrowingMoveObj>, CountingTraits> v(4);
+        v.Reserve(10);
+        assert(v.Stats().copied_elements == 4 && v.Stats().moved_elements == 0);
+        assert(v.Stats().allocations == 2 && v.Stats().reallocations == 1);
+    }
+    {
+        VectorStatsRegistry::Instance().Reset();
+        Vector<int, std::allocator<int>, RegisteredTraits> a(SIZE);
+        Vector<int, std::allocator<int>, RegisteredTraits> b;
+        b.Reserve(SIZE * 2);
+
+        bool found = false;
+        VectorStatsRegistry::Instance().ForEach([&found, SIZE](std::string_view name, const VectorStats& stats) {
+            if (name == StatsTag::NAME) {
+                found = true;
+                assert(stats.allocations == 2 && stats.reallocations == 0);
+                assert(stats.allocated_bytes == 3 * SIZE * sizeof(int));
+                assert(stats.peak_capacity == SIZE * 2);
+            }
+        });
+        assert(found);
+
+        std::ostringstream out;
+        VectorStatsRegistry::Instance().Dump(out);
+        assert(out.str().find("test: allocations=2 ") != std::string::npos);
+    }
+}
+
+// Аллокатор, выбрасывающий std::bad_alloc, когда исчерпан лимит выделений
+struct AllocationLimit {
+    inline static int remaining = -1; // -1 - без ограничения
+};
+
+template <typename T>
+struct LimitedAllocator {
+    using value_type = T;
+
+    LimitedAllocator() = default;
+    template <typename U>
+    LimitedAllocator(const LimitedAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (AllocationLimit::remaining == 0) {
+            throw std::bad_alloc();
+        }
+        if (AllocationLimit::remaining > 0) {
+            --AllocationLimit::remaining;
+        }
+        return std::allocator<T>{}.allocate(n);
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    bool operator==(const LimitedAllocator& /*other*/) const noexcept {
+        return true;
+    }
+    bool operator!=(const LimitedAllocator& /*other*/) const noexcept {
+        return false;
+    }
+};
+
+void Test17() {
+    {
+        ConcurrentVector<int> v;
+        int& first = v.EmplaceBack(0);
+        for (int i = 1; i < 1000; ++i) {
+            v.PushBack(i);
+        }
+        // Рост вектора не перемещает элементы
+        assert(&first == &v[0]);
+        assert(v.Size() == 1000 && v.IsReady(999) && !v.IsReady(1000));
+        for (int i = 0; i < 1000; ++i) {
+            assert(v[static_cast<size_t>(i)] == i);
+        }
+
+        const Vector<int> snapshot = v.Snapshot();
+        assert(snapshot.Size() == 1000 && snapshot[999] == 999);
+
+        v.Clear();
+        assert(v.Size() == 0);
+        v.PushBack(42);
+        assert(&v[0] == &first && v[0] == 42);
+    }
+    {
+        const int NUM_THREADS = 4;
+        const int PER_THREAD = 10'000;
+        ConcurrentVector<std::pair<int, int>> v;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NUM_THREADS; ++t) {
+            threads.emplace_back([&v, t] {
+                for (int i = 0; i < PER_THREAD; ++i) {
+                    auto& item = v.EmplaceBack(t, i);
+                    assert(item.first == t && item.second == i);
+                }
+            });
+        }
+        // Чтение параллельно с добавлением
+        while (v.Size() < static_cast<size_t>(NUM_THREADS * PER_THREAD) / 2) {
+            const Vector<std::pair<int, int>> snapshot = v.Snapshot();
+            assert(snapshot.Size() <= v.Size());
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        assert(v.Size() == static_cast<size_t>(NUM_THREADS * PER_THREAD));
+        // Элементы каждого потока идут в порядке добавления
+        std::vector<int> next(NUM_THREADS, 0);
+        const Vector<std::pair<int, int>> snapshot = v.Snapshot();
+        assert(snapshot.Size() == v.Size());
+        for (const auto& [thread, value] : snapshot) {
+            assert(value == next[static_cast<size_t>(thread)]);
+            ++next[static_cast<size_t>(thread)];
+        }
+    }
+    {
+        Obj::ResetCounters();
+        {
+            ConcurrentVector<Obj> v;
+            v.Reserve(100);
+            for (int i = 0; i < 10; ++i) {
+                v.EmplaceBack(i);
+            }
+            Obj thrower(100);
+            thrower.throw_on_copy = true;
+            try {
+                v.PushBack(thrower);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            v.EmplaceBack(11);
+            assert(v.Size() == 12 && !v.IsReady(10) && v.IsReady(11));
+
+            // Неудавшаяся ячейка пропускается при копировании
+            const Vector<Obj> snapshot = v.Snapshot();
+            assert(snapshot.Size() == 11 && snapshot[10].id == 11);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Ошибка выделения сегмента не резервирует ячейку
+        Obj::ResetCounters();
+        {
+            ConcurrentVector<Obj, LimitedAllocator<Obj>> v;
+            AllocationLimit::remaining = 1;
+            for (int i = 0; i < 8; ++i) {
+                v.EmplaceBack(i);
+            }
+            try {
+                v.EmplaceBack(8);
+                assert(false);
+            } catch (const std::bad_alloc&) {
+            }
+            assert(v.Size() == 8 && !v.IsReady(8));
+
+            AllocationLimit::remaining = -1;
+            assert(v.Snapshot().Size() == 8);
+            v.EmplaceBack(8);
+            assert(v.Size() == 9 && v.IsReady(8) && v[8].id == 8);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test18() {
+    const size_t SIZE = 1000;
+    using ParallelVector = Vector<SharedObj, std::allocator<SharedObj>, ParallelTraits>;
+    {
+        SharedObj::num_constructed = 0;
+        ParallelVector v(SIZE);
+        assert(v.Size() == SIZE && SharedObj::num_alive == static_cast<int>(SIZE));
+
+        ParallelVector copy(v);
+        assert(SharedObj::num_alive == static_cast<int>(SIZE * 2));
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(copy[i].id == v[i].id);
+        }
+
+        v.Reserve(SIZE * 3);
+        assert(SharedObj::num_alive == static_cast<int>(SIZE * 2));
+        assert(v[SIZE - 1].id == copy[SIZE - 1].id);
+
+        copy.Clear();
+        assert(SharedObj::num_alive == static_cast<int>(SIZE));
+    }
+    assert(SharedObj::num_alive == 0);
+    {
+        // Исключение в одной из частей откатывает все созданные элементы
+        SharedObj::num_constructed = 0;
+        SharedObj::throw_at = static_cast<int>(SIZE) / 2;
+        try {
+            ParallelVector v(SIZE);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(SharedObj::num_alive == 0);
+        SharedObj::throw_at = -1;
+    }
+    {
+        SharedObj::num_constructed = 0;
+        ParallelVector v(SIZE);
+        SharedObj::throw_at = v[SIZE * 3 / 4].id;
+        try {
+            ParallelVector copy(v);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(SharedObj::num_alive == static_cast<int>(SIZE));
+
+        // При переаллокации с копированием вектор остается неизменным
+        const SharedObj* data = v.Data();
+        try {
+            v.Reserve(SIZE * 2);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Data() == data && v.Capacity() == SIZE);
+        assert(SharedObj::num_alive == static_cast<int>(SIZE));
+        SharedObj::throw_at = -1;
+    }
+    assert(SharedObj::num_alive == 0);
+    {
+        Vector<int, std::allocator<int>, ParallelTraits> v(SIZE * 10);
+        std::iota(v.begin(), v.end(), 0);
+        v.Reserve(SIZE * 20);
+        Vector<int, std::allocator<int>, ParallelTraits> copy(v);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(copy[i] == static_cast<int>(i));
+        }
+    }
+    {
+        // Рост через EmplaceBack, Emplace и InsertRange переносит элементы по политике выполнения
+        Vector<std::string, std::allocator<std::string>, CountingExecutionTraits> v(16);
+        const int runs = CountingExecution::num_runs;
+        v.EmplaceBack("back");
+        assert(CountingExecution::num_runs > runs);
+
+        v.ShrinkToFit();
+        const int emplace_runs = CountingExecution::num_runs;
+        v.Emplace(v.cbegin(), "front");
+        assert(CountingExecution::num_runs > emplace_runs);
+
+        v.ShrinkToFit();
+        const int insert_runs = CountingExecution::num_runs;
+        const std::vector<std::string> range(20, "x");
+        v.InsertRange(v.cbegin() + 1, range.begin(), range.end());
+        assert(CountingExecution::num_runs > insert_runs);
+        assert(v.Size() == 38 && v[0] == "front" && v[1] == "x" && v[21].empty() && v[37] == "back");
+    }
+}
+
+void Test19() {
+    struct Record {
+        int64_t key;
+        double value;
+    };
+    const std::string path = "/tmp/advanced_vector_test_" + std::to_string(::getpid()) + ".bin";
+    const size_t SIZE = 10'000;
+    {
+        MappedVector<Record> v = OpenMappedVector<Record>(path);
+        assert(v.Size() == 0);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(Record{static_cast<int64_t>(i), static_cast<double>(i) / 2});
+        }
+        assert(reinterpret_cast<std::uintptr_t>(v.Data()) % MappedFile::DATA_OFFSET == 0);
+        v.GetAllocator().File().Advise(MappedAdvice::SEQUENTIAL);
+        SyncMappedVector(v);
+    }
+    {
+        // Повторное открытие не читает элементы, а отображает файл
+        MappedVector<Record> v = OpenMappedVector<Record>(path);
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        v.GetAllocator().File().Advise(MappedAdvice::WILL_NEED, sizeof(Record) * 100, sizeof(Record) * 100);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i].key == static_cast<int64_t>(i) && v[i].value == static_cast<double>(i) / 2);
+        }
+        v.PopBack();
+        v[0].key = -1;
+        v.PushBack(Record{42, 0.0});
+        v.PushBack(Record{43, 0.0});
+        SyncMappedVector(v);
+    }
+    {
+        MappedVector<Record> v = OpenMappedVector<Record>(path);
+        assert(v.Size() == SIZE + 1);
+        assert(v[0].key == -1 && v[SIZE - 1].key == 42 && v[SIZE].key == 43);
+    }
+    try {
+        MappedFile file(path, sizeof(int));
+        assert(false);
+    } catch (const std::system_error&) {
+    }
+    std::remove(path.c_str());
+
+    static_assert(!std::is_copy_constructible_v<MappedVector<int>> && !std::is_copy_assignable_v<MappedVector<int>>);
+    static_assert(std::is_nothrow_move_constructible_v<MappedVector<int>>);
+    const std::string other_path = path + ".other";
+    {
+        // Вставка и добавление диапазона в заполненный буфер расширяют отображение на месте
+        MappedVector<int> v = OpenMappedVector<int>(path);
+        v.PushBack(1);
+        v.PushBack(2);
+        assert(v.Size() == v.Capacity());
+        v.Insert(v.begin(), 0);
+        assert(v.Size() == 3 && v[0] == 0 && v[1] == 1 && v[2] == 2);
+
+        v.ShrinkToFit();
+        const std::vector<int> range = {3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+        v.AppendRange(range.begin(), range.end());
+        v.ShrinkToFit();
+        v.InsertRange(v.begin() + 1, range.begin(), range.begin() + 2);
+        assert(v.Size() == 15 && v[0] == 0 && v[1] == 3 && v[2] == 4 && v[3] == 1 && v[14] == 12);
+
+        const std::vector<int> longer(40, 7);
+        v.Assign(longer.begin(), longer.end());
+        assert(v.Size() == 40 && v[0] == 7 && v[39] == 7);
+
+        // Копирующее присваивание из другого файла тоже расширяет собственное отображение
+        MappedVector<int> other = OpenMappedVector<int>(other_path);
+        for (int i = 0; i < 100; ++i) {
+            other.PushBack(i);
+        }
+        static_cast<Vector<int, MappedFileAllocator<int>>&>(v) = other;
+        assert(v.Size() == 100 && v[0] == 0 && v[99] == 99);
+        assert(&v.GetAllocator().File() != &other.GetAllocator().File());
+
+        // Второе отображение того же файла запрещено
+        MappedFileAllocator<int> alloc = v.GetAllocator();
+        try {
+            alloc.allocate(1);
+            assert(false);
+        } catch (const std::system_error&) {
+        }
+        SyncMappedVector(v);
+    }
+    {
+        MappedVector<int> v = OpenMappedVector<int>(path);
+        assert(v.Size() == 100 && v[50] == 50);
+    }
+    std::remove(path.c_str());
+    std::remove(other_path.c_str());
+}
+
+void Test20() {
+    struct Point {
+        int32_t x;
+        int32_t y;
+    };
+    const size_t SIZE = 100'000;
+    Vector<Point> source;
+    for (size_t i = 0; i < SIZE; ++i) {
+        source.PushBack(Point{static_cast<int32_t>(i), -static_cast<int32_t>(i)});
+    }
+
+    const std::string path = "/tmp/advanced_vector_io_" + std::to_string(::getpid()) + ".bin";
+    {
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        assert(fd >= 0);
+        WriteTo(fd, source);
+        WriteTo(fd, Vector<Point>{});
+
+        ::lseek(fd, 0, SEEK_SET);
+        Vector<Point> result(3);
+        ReadFrom(fd, result);
+        assert(result.Size() == SIZE && result.Capacity() == SIZE);
+        assert(std::memcmp(result.Data(), source.Data(), SIZE * sizeof(Point)) == 0);
+
+        ReadFrom(fd, result);
+        assert(result.Size() == 0);
+
+        // Конец файла и чужой формат
+        try {
+            ReadFrom(fd, result);
+            assert(false);
+        } catch (const std::system_error&) {
+        }
+        ::lseek(fd, 0, SEEK_SET);
+        Vector<int32_t> wrong;
+        try {
+            ReadFrom(fd, wrong);
+            assert(false);
+        } catch (const std::system_error& e) {
+            assert(e.code() == std::errc::invalid_argument);
+        }
+        ::close(fd);
+        std::remove(path.c_str());
+    }
+    {
+        // Передача частями, размер которых не кратен размеру элемента
+        Vector<char> stream;
+        WriteChunks(source, 1000, [&stream](const void* data, size_t bytes) {
+            assert(bytes <= 1000);
+            const char* begin = static_cast<const char*>(data);
+            stream.AppendRange(begin, begin + bytes);
+        });
+        assert(stream.Size() == sizeof(VectorIoHeader) + SIZE * sizeof(Point));
+        const char tail[] = "next";
+        stream.AppendRange(tail, tail + sizeof(tail));
+
+        Vector<Point> result;
+        VectorStreamReader reader(result);
+        const size_t PACKET = 333;
+        size_t offset = 0;
+        while (!reader.IsComplete()) {
+            const size_t bytes = std::min(PACKET, stream.Size() - offset);
+            offset += reader.Feed(stream.Data() + offset, bytes);
+            assert(result.Size() == (offset > sizeof(VectorIoHeader)
+                ? (offset - sizeof(VectorIoHeader)) / sizeof(Point) : 0));
+        }
+        assert(stream.Size() - offset == sizeof(tail));
+        assert(result.Size() == SIZE && result[SIZE - 1].x == static_cast<int32_t>(SIZE - 1));
+    }
+    {
+        // Политика уменьшения не срабатывает на недополученном векторе
+        Vector<int> ints(1000);
+        std::iota(ints.begin(), ints.end(), 0);
+        Vector<char> stream;
+        WriteChunks(ints, 4096, [&stream](const void* data, size_t bytes) {
+            const char* begin = static_cast<const char*>(data);
+            stream.AppendRange(begin, begin + bytes);
+        });
+
+        Vector<int, std::allocator<int>, ShrinkingTraits> result;
+        VectorStreamReader reader(result);
+        const size_t PACKET = 7;
+        size_t offset = 0;
+        while (!reader.IsComplete()) {
+            offset += reader.Feed(stream.Data() + offset, std::min(PACKET, stream.Size() - offset));
+        }
+        assert(offset == stream.Size() && result.Size() == ints.Size());
+        assert(std::equal(result.begin(), result.end(), ints.begin()));
+    }
+}
+
+void Test21() {
+    using namespace std::literals;
+    const size_t SIZE = 100;
+    {
+        SoAVector<int, std::string, double> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            auto [id, name, value] = v.EmplaceBack(static_cast<int>(i), std::to_string(i), 0.5);
+            assert(id == static_cast<int>(i) && name == std::to_string(i) && value == 0.5);
+        }
+        assert(v.Size() == SIZE && v.Capacity() == 128);
+
+        // Столбцы непрерывны и независимы
+        auto values = v.Column<2>();
+        assert(values.Size() == SIZE);
+        for (double& value : values) {
+            value *= 2;
+        }
+        const auto& const_v = v;
+        const auto ids = const_v.Column<0>();
+        assert(std::accumulate(ids.begin(), ids.end(), 0) == static_cast<int>(SIZE * (SIZE - 1) / 2));
+        assert(std::get<2>(const_v[SIZE - 1]) == 1.0);
+
+        // Прокси-строка ссылается на элементы столбцов
+        std::get<1>(v[0]) = "zero"s;
+        assert(v.Column<1>()[0] == "zero"s);
+
+        v.Erase(0);
+        assert(v.Size() == SIZE - 1 && std::get<0>(v[0]) == 1 && std::get<1>(v[0]) == "1"s);
+        v.PopBack();
+        assert(std::get<0>(v[v.Size() - 1]) == static_cast<int>(SIZE) - 2);
+
+        SoAVector<int, std::string, double> copy(v);
+        v.Resize(10);
+        assert(v.Size() == 10 && copy.Size() == SIZE - 2);
+        v.Resize(20);
+        assert(std::get<0>(v[19]) == 0 && std::get<1>(v[19]).empty());
+        v = std::move(copy);
+        assert(v.Size() == SIZE - 2 && std::get<1>(v[1]) == "2"s);
+    }
+    {
+        SharedObj::num_constructed = 0;
+        {
+            // Исключение при добавлении строки оставляет вектор неизменным
+            SoAVector<std::string, SharedObj> v;
+            v.Reserve(2);
+            v.EmplaceBack("a"s, SharedObj());
+            v.EmplaceBack("b"s, SharedObj());
+            SharedObj thrower;
+            SharedObj::throw_at = thrower.id;
+            try {
+                v.EmplaceBack("c"s, thrower);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 2 && v.Capacity() == 2);
+            SharedObj::throw_at = -1;
+
+            // Исключение при копировании одного из столбцов во время переноса
+            SharedObj::throw_at = std::get<1>(v[1]).id;
+            try {
+                v.Reserve(10);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Capacity() == 2 && std::get<0>(v[0]) == "a"s && std::get<0>(v[1]) == "b"s);
+            SharedObj::throw_at = -1;
+
+            v.Reserve(10);
+            assert(v.Capacity() == 10 && std::get<0>(v[1]) == "b"s);
+            assert(SharedObj::num_alive == 3);
+        }
+        assert(SharedObj::num_alive == 0);
+    }
+}
+
+void Test22() {
+    using Alloc = HugePageAllocator<int64_t, HUGE_PAGE_TEST_THRESHOLD>;
+    {
+        Vector<int64_t, Alloc, HugePageTestTraits> v;
+        v.PushBack(0);
+        assert(Alloc::Kind(v.Data(), v.Capacity()) == HugePageKind::NONE);
+        assert(reinterpret_cast<std::uintptr_t>(v.Data()) % Alloc::ALIGNMENT == 0);
+
+        const size_t SIZE = HUGE_PAGE_TEST_THRESHOLD;  // 512 КБ данных
+        for (size_t i = 1; i < SIZE; ++i) {
+            v.PushBack(static_cast<int64_t>(i));
+        }
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == static_cast<int64_t>(i));
+        }
+
+        // Вместимость занимает целое число больших страниц вместе с заголовком
+        const size_t bytes = v.Capacity() * sizeof(int64_t) + HUGE_PAGE_HEADER_SIZE;
+        assert(bytes % HUGE_PAGE_2M == 0);
+
+        const HugePageKind kind = Alloc::Kind(v.Data(), v.Capacity());
+        assert(kind != HugePageKind::NONE);
+        if (kind != HugePageKind::FALLBACK) {
+            assert(reinterpret_cast<std::uintptr_t>(v.Data()) % HUGE_PAGE_2M == HUGE_PAGE_HEADER_SIZE);
+        }
+
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(Alloc::Kind(v.Data(), v.Capacity()) == HugePageKind::NONE && v[9] == 9);
+    }
+    {
+        HugePageVector<char> v(HUGE_PAGE_2M * 2);
+        v[HUGE_PAGE_2M * 2 - 1] = 'x';
+        assert(HugePageAllocator<char>::Kind(v.Data(), v.Capacity()) != HugePageKind::NONE);
+    }
+}
+
+void Test23() {
+    const int SIZE = 1000;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(SIZE);
+        for (int i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+
+        // На место удаленного элемента встает последний
+        auto it = v.SwapRemove(v.cbegin() + 1);
+        assert(it->id == SIZE - 1 && v.Size() == static_cast<size_t>(SIZE - 1));
+        assert(Obj::num_move_assigned == 1 && Obj::GetAliveObjectCount() == SIZE - 1);
+        it = v.SwapRemove(v.cend() - 1);
+        assert(it == v.end() && v[v.Size() - 1].id == SIZE - 3);
+
+        // Четные удаляются, порядок нечетных сохраняется
+        std::vector<int> expected;
+        for (const Obj& obj : v) {
+            if (obj.id % 2 == 1) {
+                expected.push_back(obj.id);
+            }
+        }
+        Obj::ResetCounters();
+        const size_t size = v.Size();
+        const size_t removed = v.EraseIf([](const Obj& obj) {
+            return obj.id % 2 == 0;
+        });
+        assert(removed + v.Size() == size && v.Size() == expected.size());
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i].id == expected[i]);
+        }
+        assert(Obj::num_destroyed == static_cast<int>(removed));
+        assert(Obj::num_move_assigned <= static_cast<int>(v.Size()));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+        const size_t removed = v.RemoveIf([](const Obj& obj) {
+            return obj.id % 3 != 0;
+        });
+        assert(v.Size() + removed == static_cast<size_t>(SIZE));
+        assert(v.Size() == static_cast<size_t>(SIZE + 2) / 3);
+        int sum = 0;
+        for (const Obj& obj : v) {
+            assert(obj.id % 3 == 0);
+            sum += obj.id;
+        }
+        assert(static_cast<size_t>(sum) == 3 * (v.Size() - 1) * v.Size() / 2);
+        // Каждый оставшийся элемент перемещается не больше одного раза
+        assert(Obj::num_move_assigned <= static_cast<int>(v.Size()));
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(v.Size()));
+
+        assert(v.RemoveIf([](const Obj&) { return true; }) == static_cast<size_t>(SIZE + 2) / 3);
+        assert(v.Size() == 0 && v.RemoveIf([](const Obj&) { return true; }) == 0);
+    }
+    {
+        // Предикат вызывается для каждого элемента ровно один раз
+        const std::vector<std::vector<int>> cases = {
+            {1}, {0}, {1, 1}, {0, 1}, {1, 0}, {1, 0, 1}, {0, 1, 1, 0, 1}, {1, 1, 0, 0, 1, 1}, {1, 0, 0, 0, 1},
+        };
+        for (const std::vector<int>& remove : cases) {
+            Vector<int> v;
+            for (size_t i = 0; i < remove.size(); ++i) {
+                v.PushBack(static_cast<int>(i));
+            }
+            std::vector<int> calls(remove.size(), 0);
+            const size_t removed = v.RemoveIf([&](int value) {
+                ++calls[static_cast<size_t>(value)];
+                return remove[static_cast<size_t>(value)] == 1;
+            });
+            assert(std::all_of(calls.begin(), calls.end(), [](int count) { return count == 1; }));
+            assert(removed == static_cast<size_t>(std::count(remove.begin(), remove.end(), 1)));
+            assert(std::none_of(v.begin(), v.end(), [&](int value) { return remove[static_cast<size_t>(value)] == 1; }));
+        }
+    }
+    {
+        // Тривиально перемещаемые объекты переносятся побайтово
+        Vector<RelocatableObj> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.SwapRemove(v.cbegin());
+        assert(*v[0].value == SIZE - 1);
+        assert(v.EraseIf([](const RelocatableObj& obj) { return *obj.value < SIZE / 2; }) == SIZE / 2 - 1);
+        assert(v.Size() == static_cast<size_t>(SIZE / 2) && *v[0].value == SIZE - 1 && *v[1].value == SIZE / 2);
+
+        // Исключение в предикате не оставляет дыр
+        int calls = 0;
+        try {
+            v.EraseIf([&calls](const RelocatableObj& obj) {
+                if (++calls == 100) {
+                    throw std::runtime_error("Oops");
+                }
+                return *obj.value % 2 == 0;
+            });
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        for (const RelocatableObj& obj : v) {
+            assert(obj.value != nullptr);
+        }
+    }
+    {
+        Vector<int, std::allocator<int>, ShrinkingTraits> v(1024);
+        std::iota(v.begin(), v.end(), 0);
+        v.EraseIf([](int value) {
+            return value >= 100;
+        });
+        assert(v.Size() == 100 && v.Capacity() == 200 && v[99] == 99);
+    }
+}
+
+void Test24() {
+    const int SIZE = 10;
+    {
+        // Вставка в конец добавляет ровно один элемент
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(SIZE + 1);
+        auto it = v.Emplace(v.cend(), 1);
+        assert(v.Size() == 1 && it == v.begin() && it->id == 1);
+        assert(Obj::GetAliveObjectCount() == 1);
+    }
+    {
+        Vector<Obj> v;
+        v.Reserve(SIZE + 3);
+        for (int i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+
+        // Вставка значения типа T не создает временный объект
+        Obj::ResetCounters();
+        Obj value(100);
+        v.Insert(v.cbegin() + 1, std::move(value));
+        assert(v[1].id == 100 && v[2].id == 1);
+        assert(Obj::num_moved == 1 && Obj::num_move_assigned == SIZE - 1);
+        assert(Obj::num_destroyed == 0);
+
+        // Вставка ссылки на элемент сдвигаемой части вектора
+        v.Insert(v.cbegin(), v[3]);
+        assert(v[0].id == 2 && v[4].id == 2);
+        v.Insert(v.cbegin() + 1, v[v.Size() - 1]);
+        assert(v[1].id == SIZE - 1 && v[v.Size() - 1].id == SIZE - 1);
+        // Счетчики сброшены после заполнения: три вставленных элемента и value
+        assert(v.Size() == static_cast<size_t>(SIZE + 3) && Obj::GetAliveObjectCount() == 4);
+    }
+    {
+        // Тривиально перемещаемый тип конструируется один раз и сдвигается memmove
+        Vector<RelocatableObj> v;
+        v.Reserve(SIZE + 2);
+        for (int i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+        const int* tail = v[SIZE - 1].value.get();
+        auto it = v.Emplace(v.cbegin() + 2, 100);
+        assert(*it->value == 100 && *v[3].value == 2);
+        assert(v[SIZE].value.get() == tail);
+        // Аргумент может ссылаться на элемент вектора
+        v.Emplace(v.cbegin(), *v[5].value);
+        assert(*v[0].value == 4 && *v[6].value == 4);
+    }
+    {
+        // При переаллокации с копированием вектор остается неизменным
+        SharedObj::num_constructed = 0;
+        Vector<SharedObj> v(SIZE);
+        SharedObj::throw_at = v[SIZE - 1].id;
+        try {
+            v.Emplace(v.cbegin() + 1);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == static_cast<size_t>(SIZE) && v.Capacity() == static_cast<size_t>(SIZE));
+        assert(SharedObj::num_alive == SIZE);
+        SharedObj::throw_at = -1;
+
+        v.Emplace(v.cbegin() + 1);
+        assert(v.Size() == static_cast<size_t>(SIZE + 1) && SharedObj::num_alive == SIZE + 1);
+        assert(v[0].id == 0 && v[2].id == 1);
+    }
+    assert(SharedObj::num_alive == 0);
+}
+
+// Проверяет StaticVector в константном выражении
+constexpr StaticVector<int, 8> MakeStaticVector() {
+    StaticVector<int, 8> v({3, 4});
+    v.PushBack(5);
+    v.Emplace(v.cbegin(), 1);
+    v.Insert(v.cbegin() + 1, 2);
+    v.Erase(v.cbegin() + 4);
+    StaticVector<int, 8> other(2);
+    other.Swap(v);
+    return other;
+}
+
+void Test25() {
+    {
+        constexpr StaticVector<int, 8> v = MakeStaticVector();
+        static_assert(v.Size() == 4 && v[0] == 1 && v[1] == 2 && v[2] == 3 && v[3] == 4);
+        static_assert(StaticVector<int, 8>::Capacity() == 8);
+        // Размер хранится в минимальном подходящем типе
+        static_assert(sizeof(StaticVector<uint8_t, 16>) == 17);
+        static_assert(std::is_trivially_copyable_v<StaticVector<int, 8>>);
+        static_assert(IsTriviallyRelocatable_v<StaticVector<RelocatableObj, 2>>);
+
+        StaticVector<int, 4> d(DEFAULT_INIT);
+        assert(d.Size() == 0);
+    }
+    {
+        // Переполнение: TryEmplaceBack возвращает false, ThrowOverflow выбрасывает исключение
+        StaticVector<int, 2, ThrowOverflow> v;
+        assert(v.TryEmplaceBack(1) && v.TryPushBack(2));
+        assert(v.IsFull() && !v.TryEmplaceBack(3));
+        try {
+            v.PushBack(3);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        try {
+            v.Emplace(v.cbegin(), 0);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        try {
+            StaticVector<int, 2, ThrowOverflow> big(3);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(v.Size() == 2 && v[0] == 1 && v[1] == 2);
+    }
+    const size_t SIZE = 6;
+    {
+        Obj::ResetCounters();
+        StaticVector<Obj, SIZE> v(3);
+        v.EmplaceBack(3);
+        v.Emplace(v.cbegin() + 1, 10);
+        v.Insert(v.cbegin(), v[4]);
+        assert(v.Size() == SIZE && v[0].id == 3 && v[2].id == 10 && v[5].id == 3);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
+
+        // Исключение конструктора не меняет вектор
+        v.PopBack();
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.EmplaceBack();
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE - 1 && Obj::GetAliveObjectCount() == static_cast<int>(SIZE - 1));
+
+        StaticVector<Obj, SIZE> copy(v);
+        assert(copy.Size() == v.Size() && copy[2].id == 10);
+        StaticVector<Obj, SIZE> moved(std::move(copy));
+        assert(moved.Size() == SIZE - 1 && copy.Size() == 0);
+
+        StaticVector<Obj, SIZE> small(1);
+        small.Swap(moved);
+        assert(small.Size() == SIZE - 1 && moved.Size() == 1 && small[2].id == 10);
+        moved = small;
+        assert(moved.Size() == SIZE - 1 && moved[2].id == 10);
+        small.Erase(small.cbegin());
+        assert(small.Size() == SIZE - 2 && small[1].id == 10);
+        small.Clear();
+        assert(small.Size() == 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        StaticVector<RelocatableObj, SIZE> v;
+        for (int i = 0; i < 4; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Emplace(v.cbegin(), *v[3].value);
+        assert(*v[0].value == 3 && *v[4].value == 3);
+    }
+}
+
+void Test26() {
+    const size_t SIZE = 8;
+    {
+        Obj::ResetCounters();
+        CowVector<Obj> a(SIZE);
+        const CowVector<Obj> b = a;
+        assert(a.UseCount() == 2 && b.Data() == std::as_const(a).Data());
+        assert(Obj::num_copied == 0 && Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
+
+        // Первое изменение копирует элементы, копия остается неизменной
+        a[0].id = 100;
+        assert(!a.IsShared() && !b.IsShared() && b.Data() != std::as_const(a).Data());
+        assert(a[0].id == 100 && b[0].id == 0);
+        assert(Obj::num_copied == static_cast<int>(SIZE));
+
+        // Аргумент может ссылаться на элемент разделяемого буфера
+        CowVector<Obj> c = b;
+        c.PushBack(std::as_const(c)[SIZE - 1]);
+        c.Insert(c.cbegin(), std::as_const(c)[1]);
+        assert(c.Size() == SIZE + 2 && b.Size() == SIZE && b.UseCount() == 1);
+
+        // Удаление из разделяемого буфера копирует только оставшиеся элементы
+        CowVector<Obj> d = a;
+        const int copied = Obj::num_copied;
+        const int move_assigned = Obj::num_move_assigned;
+        auto it = d.Erase(std::as_const(d).cbegin());
+        assert(it == d.begin() && d.Size() == SIZE - 1 && a.Size() == SIZE);
+        assert(Obj::num_copied - copied == static_cast<int>(SIZE - 1) && Obj::num_move_assigned == move_assigned);
+        CowVector<Obj> e = d;
+        e.PopBack();
+        e.Resize(2);
+        assert(e.Size() == 2 && d.Size() == SIZE - 1);
+        e = d;
+        e.Clear();
+        assert(e.Size() == 0 && d.Size() == SIZE - 1);
+        e.EmplaceBack(1);
+        assert(e.Size() == 1 && e[0].id == 1);
+    }
+    {
+        // Исключение при отделении буфера оставляет вектор разделяемым
+        CowVector<Obj> a(SIZE);
+        CowVector<Obj> b = a;
+        const_cast<Obj&>(std::as_const(a)[SIZE / 2]).throw_on_copy = true;
+        try {
+            a.PushBack(Obj(1));
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(a.UseCount() == 2 && a.Size() == SIZE);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Копии передаются в потоки и изменяются независимо
+        Vector<int> values(1000);
+        std::iota(values.begin(), values.end(), 0);
+        const CowVector<int> shared(std::move(values));
+
+        const int NUM_THREADS = 4;
+        std::vector<std::thread> threads;
+        std::atomic<int> failures = 0;
+        for (int t = 0; t < NUM_THREADS; ++t) {
+            threads.emplace_back([&shared, &failures, t] {
+                for (int i = 0; i < 100; ++i) {
+                    CowVector<int> copy = shared;
+                    if (i % 10 == 0) {
+                        copy[0] = t;
+                    }
+                    if (std::as_const(copy)[999] != 999 || std::as_const(copy)[0] != (i % 10 == 0 ? t : 0)) {
+                        ++failures;
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        assert(failures == 0 && shared.UseCount() == 1 && shared[0] == 0);
+        assert(shared.ToVector().Size() == 1000);
+    }
+}
+
+void Test27() {
+    const size_t SIZE = 16;
+    {
+        // Тривиально копируемые элементы копируются в существующий буфер
+        Vector<int, CountingAllocator<int>> src(SIZE);
+        std::iota(src.begin(), src.end(), 0);
+        Vector<int, CountingAllocator<int>> dst(SIZE * 2);
+        const int* data = dst.Data();
+        AllocationStats::Reset();
+        dst = src;
+        assert(dst.Size() == SIZE && dst.Data() == data && dst[SIZE - 1] == static_cast<int>(SIZE - 1));
+        assert(AllocationStats::num_allocations == 0);
+
+        // При нехватке вместимости выделяется буфер ровно под новый размер
+        Vector<int, CountingAllocator<int>> small(2);
+        AllocationStats::Reset();
+        small = src;
+        assert(small.Size() == SIZE && small.Capacity() == SIZE && small[3] == 3);
+        assert(AllocationStats::num_allocations == 1);
+        Vector<int, CountingAllocator<int>> empty;
+        small = empty;
+        assert(small.Size() == 0 && small.Capacity() == SIZE);
+    }
+    {
+        // Нетривиальные элементы переносятся в расширенный буфер и получают значения присваиванием
+        Vector<Obj> src;
+        for (size_t i = 0; i < SIZE; ++i) {
+            src.EmplaceBack(static_cast<int>(i));
+        }
+        Vector<Obj> dst(SIZE / 2);
+        Obj::ResetCounters();
+        dst = src;
+        assert(dst.Size() == SIZE && dst.Capacity() == SIZE && dst[SIZE - 1].id == static_cast<int>(SIZE - 1));
+        assert(Obj::num_moved == static_cast<int>(SIZE / 2) && Obj::num_assigned == static_cast<int>(SIZE / 2));
+        assert(Obj::num_copied == static_cast<int>(SIZE / 2) && Obj::num_destroyed == static_cast<int>(SIZE / 2));
+
+        // Строки сохраняют свою память при присваивании
+        Vector<std::string> strings(2, DEFAULT_INIT);
+        strings[0].reserve(64);
+        Vector<std::string> long_strings;
+        long_strings.PushBack(std::string(40, 'a'));
+        long_strings.PushBack(std::string(40, 'b'));
+        long_strings.PushBack(std::string(40, 'c'));
+        const char* buffer = strings[0].data();
+        strings = long_strings;
+        assert(strings.Size() == 3 && strings[0].data() == buffer && strings[2] == long_strings[2]);
+    }
+    {
+        // Для типов, копируемых при переносе, сохраняется copy-and-swap
+        Vector<SharedObj> src(SIZE);
+        Vector<SharedObj> dst(2);
+        SharedObj::throw_at = src[SIZE - 1].id;
+        try {
+            dst = src;
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        SharedObj::throw_at = -1;
+        assert(dst.Size() == 2 && dst.Capacity() == 2);
+        dst = src;
+        assert(dst.Size() == SIZE && dst[SIZE - 1].id == src[SIZE - 1].id);
+    }
+}
+
+// Проверяет, что элементы вектора совпадают с ожидаемыми значениями
+template <typename Container>
+bool HasIds(const Container& v, const std::vector<int>& ids) {
+    if (v.Size() != ids.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (v[i].id != ids[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+void TestDevectorOperations() {
+    Devector<T> v;
+    std::deque<int> expected;
+    // Псевдослучайная последовательность операций сверяется с std::deque
+    unsigned state = 12345;
+    for (int step = 0; step < 2000; ++step) {
+        state = state * 1103515245 + 12345;
+        const unsigned op = (state >> 16) % 6;
+        const size_t index = expected.empty() ? 0 : (state >> 8) % (expected.size() + 1);
+        if (op == 0) {
+            v.EmplaceBack(step);
+            expected.push_back(step);
+        } else if (op == 1) {
+            v.EmplaceFront(step);
+            expected.push_front(step);
+        } else if (op == 2) {
+            v.Emplace(v.cbegin() + index, step);
+            expected.insert(expected.begin() + index, step);
+        } else if (op == 3 && !expected.empty()) {
+            v.PopFront();
+            expected.pop_front();
+        } else if (op == 4 && !expected.empty()) {
+            v.PopBack();
+            expected.pop_back();
+        } else if (op == 5 && index < expected.size()) {
+            v.Erase(v.cbegin() + index);
+            expected.erase(expected.begin() + index);
+        }
+        assert(HasIds(v, std::vector<int>(expected.begin(), expected.end())));
+    }
+}
+
+void Test28() {
+    Obj::ResetCounters();
+    TestDevectorOperations<Obj>();
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Тривиально копируемый тип сдвигается memmove
+        struct Id {
+            explicit Id(int id)
+                : id(id)  //
+            {
+            }
+            int id;
+        };
+        TestDevectorOperations<Id>();
+    }
+    {
+        // Вставка в начало не сдвигает элементы
+        const int SIZE = 100;
+        Devector<Obj> v;
+        v.ReserveFront(SIZE);
+        assert(v.FrontCapacity() == static_cast<size_t>(SIZE));
+        Obj::ResetCounters();
+        for (int i = 0; i < SIZE; ++i) {
+            v.EmplaceFront(i);
+        }
+        assert(Obj::num_moved == 0 && Obj::num_move_assigned == 0);
+        assert(v[0].id == SIZE - 1 && v[SIZE - 1].id == 0);
+
+        // В середине сдвигается более короткая часть
+        v.EmplaceBack(SIZE);
+        Obj::ResetCounters();
+        v.Emplace(v.cbegin() + 2, -1);
+        assert(Obj::num_moved == 1 && Obj::num_move_assigned == 1 + 1);
+        Obj::ResetCounters();
+        v.Erase(v.cbegin() + (v.Size() - 3));
+        assert(Obj::num_move_assigned == 2);
+
+        // Аргумент может ссылаться на элемент вектора
+        v.Insert(v.cbegin() + 1, v[0]);
+        assert(v[0].id == SIZE - 1 && v[1].id == SIZE - 1);
+    }
+    {
+        // Очередь со скользящим окном не расширяет буфер
+        Devector<int> queue;
+        for (int i = 0; i < 16; ++i) {
+            queue.PushBack(i);
+        }
+        queue.PushBack(16);
+        queue.PopFront();
+        const size_t capacity = queue.Capacity();
+        for (int i = 17; i < 10000; ++i) {
+            queue.PushBack(i);
+            queue.PopFront();
+        }
+        assert(queue.Capacity() == capacity && queue.Size() == 16 && queue[0] == 10000 - 16);
+
+        Devector<int> copy = queue;
+        assert(copy.Size() == 16 && copy[15] == 9999);
+        Devector<int> moved = std::move(copy);
+        assert(moved.Size() == 16 && copy.Size() == 0);
+        moved.Resize(2);
+        moved.Swap(queue);
+        assert(queue.Size() == 2 && moved.Size() == 16);
+    }
+}
+
+void Test29() {
+    {
+        // Рост не перемещает элементы, их адреса стабильны
+        const int SIZE = 1000;
+        SegmentedVector<Obj> v;
+        Obj::ResetCounters();
+        v.EmplaceBack(0);
+        const Obj* first = &v[0];
+        for (int i = 1; i < SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(Obj::num_moved == 0 && Obj::num_copied == 0);
+        assert(&v[0] == first && v.Size() == static_cast<size_t>(SIZE));
+        assert(v.Capacity() >= v.Size() && v.SegmentCount() < 8);
+        for (int i = 0; i < SIZE; ++i) {
+            assert(v[i].id == i);
+        }
+
+        // Аргумент может ссылаться на элемент вектора
+        while (v.Size() != v.Capacity()) {
+            v.EmplaceBack(static_cast<int>(v.Size()));
+        }
+        v.EmplaceBack(v[0]);
+        assert(v[v.Size() - 1].id == 0);
+
+        size_t total = 0;
+        size_t parts = 0;
+        v.ForEachSegment([&total, &parts](const Obj* /*data*/, size_t n) {
+            total += n;
+            ++parts;
+        });
+        assert(total == v.Size() && parts == v.SegmentCount());
+
+        const int copied = Obj::num_copied;
+        SegmentedVector<Obj> copy = v;
+        assert(Obj::num_copied - copied == static_cast<int>(v.Size()) && copy[SIZE - 1].id == SIZE - 1);
+        Vector<Obj> flat = copy.Flatten();
+        assert(flat.Size() == copy.Size() && flat[SIZE - 1].id == SIZE - 1);
+        const int copied_before_move = Obj::num_copied;
+        flat = std::move(copy).Flatten();
+        assert(Obj::num_copied == copied_before_move && copy.Size() == 0 && flat.Size() == v.Size());
+
+        v.Clear();
+        const size_t capacity = v.Capacity();
+        assert(v.Size() == 0 && capacity != 0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0 && v.SegmentCount() == 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Тип без перемещения и копирования допускает рост
+        struct Pinned {
+            explicit Pinned(int id)
+                : id(id)  //
+            {
+            }
+            Pinned(const Pinned&) = delete;
+            Pinned& operator=(const Pinned&) = delete;
+            int id;
+        };
+        SegmentedVector<Pinned> v;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v[99].id == 99 && v.Size() == 100);
+    }
+    {
+        // Итераторы произвольного доступа работают со стандартными алгоритмами
+        SegmentedVector<int> v;
+        for (int i = 0; i < 200; ++i) {
+            v.PushBack(199 - i);
+        }
+        std::sort(v.begin(), v.end());
+        for (int i = 0; i < 200; ++i) {
+            assert(v[i] == i);
+        }
+        assert(std::accumulate(v.cbegin(), v.cend(), 0) == 199 * 200 / 2);
+        SegmentedVector<int>::const_iterator it = v.begin() + 50;
+        assert(*it == 50 && it[10] == 60 && it - v.cbegin() == 50);
+        assert(*(it - 20) == 30 && v.end() - v.begin() == 200 && it < v.cend());
+        assert(std::lower_bound(v.begin(), v.end(), 123) - v.begin() == 123);
+
+        SegmentedVector<int> other;
+        other = v;
+        other.Swap(v);
+        SegmentedVector<int> moved = std::move(other);
+        assert(moved.Size() == 200 && other.Size() == 0 && v[199] == 199);
+    }
+    {
+        // ConcurrentVector использует ту же раскладку индексов
+        ConcurrentVector<int> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+        }
+        for (int i = 0; i < 1000; ++i) {
+            assert(v[i] == i);
+        }
+    }
+}
+
+void Test30() {
+    {
+        // Политика ThrowChecks проверяет предусловия в любой сборке
+        Vector<int, std::allocator<int>, CheckTraits<ThrowChecks>> v;
+        static_assert(!noexcept(v[0]) && !noexcept(v.PopBack()) && noexcept(v.UncheckedAt(0)));
+        auto expect_throw = [](auto operation) {
+            try {
+                operation();
+            } catch (const std::out_of_range&) {
+                return;
+            }
+            assert(false);
+        };
+        expect_throw([&v] {
+            v.PopBack();
+        });
+        // Запас вместимости, чтобы итератор cend() + 1 оставался в пределах буфера
+        v.Reserve(8);
+        for (int i = 0; i < 4; ++i) {
+            v.PushBack(i);
+        }
+        expect_throw([&v] {
+            return v[4];
+        });
+        expect_throw([&v] {
+            v.Erase(v.cend());
+        });
+        expect_throw([&v] {
+            v.Emplace(v.cend() + 1, 0);
+        });
+        expect_throw([&v] {
+            v.EraseRange(v.cbegin() + 2, v.cbegin() + 1);
+        });
+        expect_throw([&v] {
+            v.SwapRemove(v.cend());
+        });
+        // Проверка выполняется до изменения вектора
+        assert(v.Size() == 4 && v[3] == 3 && v.UncheckedAt(2) == 2);
+        v.Erase(v.cbegin());
+        v.PopBack();
+        assert(v.Size() == 2 && v[0] == 1 && v[1] == 2);
+
+        // Результат ResizeAndOverwrite и обращения к RawMemory проверяются той же политикой
+        expect_throw([&v] {
+            v.ResizeAndOverwrite(4, [](int*, size_t n) {
+                return n + 1;
+            });
+        });
+        assert(v.Size() == 4 && v[0] == 1 && v[1] == 2);
+        RawMemory<int, std::allocator<int>, ThrowChecks> memory(4);
+        static_assert(!noexcept(memory[0]) && !noexcept(memory + 0));
+        assert(memory + 4 == memory.GetAddress() + 4);
+        expect_throw([&memory] {
+            return memory[4];
+        });
+        expect_throw([&memory] {
+            return memory + 5;
+        });
+    }
+    {
+        // По умолчанию проверки выполняются assert, операции не выбрасывают исключений
+        Vector<int> v(3);
+        static_assert(noexcept(v[0]) && noexcept(v.PopBack()));
+        v.UncheckedAt(1) = 5;
+        assert(v[1] == 5);
+
+        Vector<int, std::allocator<int>, CheckTraits<NoChecks>> unchecked(3);
+        Vector<int, std::allocator<int>, CheckTraits<LogChecks>> logged(3);
+        static_assert(noexcept(unchecked[0]) && noexcept(logged[0]));
+        unchecked[2] = 7;
+        logged[2] = unchecked[2];
+        logged.PopBack();
+        assert(logged.Size() == 2 && unchecked.UncheckedAt(2) == 7);
+    }
+}
+
+template <typename T>
+void TestSimdAlgorithms() {
+    unsigned state = 42;
+    for (size_t size = 0; size < 150; size += (size < 40 ? 1 : 13)) {
+        Vector<T> v(size);
+        for (size_t i = 0; i < size; ++i) {
+            state = state * 1103515245 + 12345;
+            v[i] = static_cast<T>(static_cast<int>((state >> 16) % 41) - 20);
+        }
+        const T value = static_cast<T>(7);
+        assert(Find(v, value) == std::find(v.begin(), v.end(), value));
+        assert(Count(v, value) == static_cast<size_t>(std::count(v.begin(), v.end(), value)));
+        // Целые и небольшие дробные значения складываются точно в любом порядке
+        assert(Sum(v) == std::accumulate(v.begin(), v.end(), T{}));
+        if (size != 0) {
+            const auto [min, max] = std::minmax_element(v.begin(), v.end());
+            assert(MinMax(v) == std::make_pair(*min, *max));
+        }
+
+        Vector<T> copy = v;
+        assert(Equal(v, copy));
+        if (size != 0) {
+            copy[size - 1] = static_cast<T>(100);
+            assert(!Equal(v, copy));
+            copy[size - 1] = v[size - 1];
+            copy[size / 2] = static_cast<T>(-100);
+            assert(!Equal(v, copy) && Find(copy, static_cast<T>(-100)) - copy.cbegin() == static_cast<ptrdiff_t>(size / 2));
+        }
+        copy.PushBack(T{});
+        assert(!Equal(v, copy));
+
+        Fill(v, value);
+        assert(Count(v, value) == size && std::all_of(v.begin(), v.end(), [value](T x) {
+            return x == value;
+        }));
+    }
+}
+
+void Test31() {
+    const SimdLevel detected = GetSimdLevel();
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512, SimdLevel::NEON}) {
+        // Недоступный процессору уровень заменяется поддерживаемым
+        const SimdLevel active = SetSimdLevel(level);
+        assert(active == GetSimdLevel() && active <= std::max(detected, SimdLevel::NEON));
+        TestSimdAlgorithms<int32_t>();
+        TestSimdAlgorithms<uint32_t>();
+        TestSimdAlgorithms<int64_t>();
+        TestSimdAlgorithms<float>();
+        TestSimdAlgorithms<double>();
+        // Типы без векторных ядер обрабатываются алгоритмами std::
+        TestSimdAlgorithms<int16_t>();
+    }
+    SetSimdLevel(detected);
+    {
+        // Сравнение поэлементное, а не побайтовое
+        Vector<float> lhs(20);
+        Vector<float> rhs(20);
+        rhs[17] = -0.0f;
+        assert(Equal(lhs, rhs));
+        lhs[17] = std::numeric_limits<float>::quiet_NaN();
+        rhs[17] = lhs[17];
+        assert(!Equal(lhs, rhs));
+
+        Vector<int32_t> overflow(100);
+        Fill(overflow, std::numeric_limits<int32_t>::max());
+        assert(Sum(overflow) == static_cast<int32_t>(100u * static_cast<uint32_t>(std::numeric_limits<int32_t>::max())));
+
+        Vector<int> empty;
+        assert(Find(empty, 0) == empty.end() && Count(empty, 0) == 0 && Sum(empty) == 0);
+        try {
+            MinMax(empty);
+            assert(false);
+        } catch (const std::invalid_argument&) {
+        }
+    }
+}
+
+void Test32() {
+    BlockCache& cache = BlockCache::Local();
+    cache.Trim();
+    cache.ResetStats();
+    {
+        // Освобожденный буфер достается следующему вектору того же класса
+        const int* address = nullptr;
+        {
+            CachedVector<int> v;
+            v.Reserve(8);
+            address = v.Data();
+        }
+        assert(cache.Stats().misses == 1 && cache.Stats().cached_blocks == 1);
+        CachedVector<int> v;
+        v.Reserve(7);
+        assert(v.Data() == address && cache.Stats().hits == 1 && cache.Stats().cached_blocks == 0);
+        // При росте вместимость дополняется до размера класса
+        CachedVector<int> grown;
+        grown.PushBack(1);
+        assert(grown.Capacity() == BlockCache::MIN_CLASS_BYTES / sizeof(int));
+    }
+    {
+        // Короткоживущие векторы после первой итерации не обращаются к operator new
+        cache.ResetStats();
+        for (int i = 0; i < 1000; ++i) {
+            CachedVector<int> v;
+            for (int j = 0; j < 100; ++j) {
+                v.PushBack(j);
+            }
+            assert(v.Size() == 100 && v[99] == 99);
+        }
+        // Вектор растет через 6 классов: 16, 32, ..., 512 байт
+        assert(cache.Stats().misses <= 6 && cache.Stats().hits + cache.Stats().misses == 6 * 1000);
+
+        struct Triple {
+            int a, b, c;
+        };
+        CachedVector<Triple> triples;
+        for (int i = 0; i < 3; ++i) {
+            triples.PushBack(Triple{i, i, i});
+        }
+        assert(triples.Capacity() == 64 / sizeof(Triple));
+    }
+    {
+        // Каждый список хранит ограниченное число блоков, крупные блоки не кешируются
+        cache.Trim();
+        cache.ResetStats();
+        Vector<CachedVector<int>> many;
+        for (size_t i = 0; i < BlockCache::MAX_BLOCKS_PER_CLASS + 10; ++i) {
+            many.EmplaceBack(4);
+        }
+        many.Clear();
+        assert(cache.Stats().cached_blocks == BlockCache::MAX_BLOCKS_PER_CLASS && cache.Stats().released == 10);
+        assert(cache.Stats().cached_bytes == BlockCache::MAX_BLOCKS_PER_CLASS * BlockCache::MIN_CLASS_BYTES);
+
+        CachedVector<char> large(BlockCache::MAX_CLASS_BYTES + 1);
+        assert(cache.Stats().bypassed == 1);
+
+        cache.Trim();
+        assert(cache.Stats().cached_blocks == 0 && cache.Stats().cached_bytes == 0);
+    }
+    {
+        // У каждого потока свой кеш, блок можно освободить в другом потоке
+        CachedVector<int> from_thread;
+        std::thread worker([&from_thread] {
+            CachedVector<int> v(10);
+            from_thread = std::move(v);
+            assert(BlockCache::Local().Stats().misses == 1);
+        });
+        worker.join();
+        cache.ResetStats();
+        from_thread = CachedVector<int>();
+        assert(cache.Stats().cached_blocks == 1);
+    }
+    assert(BlockCache::ClassBytes(1) == BlockCache::MIN_CLASS_BYTES && BlockCache::ClassBytes(17) == 32);
+    assert(BlockCache::ClassBytes(BlockCache::MAX_CLASS_BYTES) == BlockCache::MAX_CLASS_BYTES);
+    cache.Trim();
+}
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+// Поток, выдающий фрагменты по одному по мере вызовов Deliver, как сетевое соединение
+class ChunkedStream {
+public:
+    struct ReadAwaiter {
+        ChunkedStream* stream;
+        char* data;
+        size_t size;
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> handle) noexcept {
+            stream->pending_ = this;
+            stream->reader_ = handle;
+        }
+        size_t await_resume() const noexcept {
+            return stream->received_;
+        }
+    };
+
+    ReadAwaiter Read(char* data, size_t size) noexcept {
+        ++reads_;
+        return {this, data, size};
+    }
+    // Записывает фрагмент прямо в буфер ожидающего чтения и возобновляет его
+    void Deliver(std::string_view chunk) {
+        assert(pending_ != nullptr && chunk.size() <= pending_->size);
+        std::copy(chunk.begin(), chunk.end(), pending_->data);
+        received_ = chunk.size();
+        Resume();
+    }
+    void Close() {
+        received_ = 0;
+        Resume();
+    }
+    int Reads() const noexcept {
+        return reads_;
+    }
+
+private:
+    ReadAwaiter* pending_ = nullptr;
+    std::coroutine_handle<> reader_;
+    size_t received_ = 0;
+    int reads_ = 0;
+
+    void Resume() {
+        pending_ = nullptr;
+        std::exchange(reader_, nullptr).resume();
+    }
+};
+
+VectorFillTask ReadAll(Vector<char>& target, ChunkedStream& stream, size_t* total) {
+    VectorFillTask fill = AppendChunks(target, [&stream](char* data, size_t size) {
+        return stream.Read(data, size);
+    }, 4);
+    *total = co_await fill;
+    co_return *total;
+}
+#endif
+
+void Test33() {
+    {
+        // Производитель пишет прямо в хвост буфера и публикует записанное
+        Vector<std::byte> v;
+        const WriteBuffer<std::byte> buffer = v.GetWriteBuffer(10);
+        assert(buffer.size >= 10 && v.Size() == 0 && buffer.data == v.Data());
+        std::fill(buffer.begin(), buffer.begin() + 5, std::byte{7});
+        v.Commit(5);
+        assert(v.Size() == 5 && v[4] == std::byte{7});
+        const WriteBuffer<std::byte> tail = v.GetWriteBuffer(1);
+        assert(tail.data == v.Data() + 5 && tail.size == v.Capacity() - 5);
+        v.Commit(0);
+        assert(v.Size() == 5);
+    }
+    {
+        // Буфер растет по политике роста, а не на каждый фрагмент
+        struct Record {
+            int id;
+            double value;
+        };
+        Vector<Record, CountingAllocator<Record>> records;
+        AllocationStats::Reset();
+        for (int i = 0; i < 1000; ++i) {
+            const WriteBuffer<Record> buffer = records.GetWriteBuffer(3);
+            for (int k = 0; k < 3; ++k) {
+                buffer.data[k] = Record{3 * i + k, 0.5 * k};
+            }
+            records.Commit(3);
+        }
+        assert(records.Size() == 3000 && records[2999].id == 2999 && records[1].value == 0.5);
+        assert(AllocationStats::num_allocations <= 12);
+    }
+    {
+        Vector<int, std::allocator<int>, CheckTraits<ThrowChecks>> v;
+        const WriteBuffer<int> buffer = v.GetWriteBuffer(2);
+        try {
+            v.Commit(buffer.size + 1);
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+        assert(v.Size() == 0);
+    }
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+    {
+        // Сопрограмма добавляет фрагменты по мере поступления
+        Vector<char> target;
+        ChunkedStream stream;
+        size_t total = 0;
+        VectorFillTask task = ReadAll(target, stream, &total);
+        assert(!task.IsDone() && stream.Reads() == 1);
+        stream.Deliver("abcd");
+        stream.Deliver("ef");
+        assert(target.Size() == 6 && stream.Reads() == 3 && !task.IsDone());
+        stream.Deliver(std::string(10, 'x'));
+        stream.Close();
+        assert(task.IsDone() && task.Get() == 16 && total == 16);
+        assert(std::string_view(target.Data(), target.Size()) == "abcdef" + std::string(10, 'x'));
+    }
+#endif
+}
+
+void Test34() {
+    static_assert(detail::MOVE_ELEMENTS_COPIES<SharedObj> && !detail::MOVE_ELEMENTS_COPIES<Obj>);
+    ResetCopyFallbackStats();
+    {
+        // Конструктор перемещения SharedObj не noexcept, поэтому рост копирует элементы
+        Vector<SharedObj> v;
+        for (int i = 0; i < 9; ++i) {
+            v.EmplaceBack();
+        }
+        // Переносы при росте вместимости 1 -> 2 -> 4 -> 8 -> 16
+        CopyFallbackStats stats = GetCopyFallbackStats();
+        assert(stats.operations == 4 && stats.elements == 1 + 2 + 4 + 8);
+
+        // Уменьшение буфера и вставка в заполненный буфер тоже переносят копированием
+        v.ShrinkToFit();
+        v.Emplace(v.cbegin());
+        stats = GetCopyFallbackStats();
+        assert(stats.operations == 6 && stats.elements == 15 + 9 + 9);
+    }
+    {
+        // Перемещаемые без исключений типы не учитываются
+        ResetCopyFallbackStats();
+        Vector<Obj> objects;
+        Vector<std::string> strings;
+        for (int i = 0; i < 100; ++i) {
+            objects.EmplaceBack(i);
+            strings.EmplaceBack(std::to_string(i));
+        }
+        objects.Emplace(objects.cbegin(), -1);
+        assert(GetCopyFallbackStats().operations == 0 && GetCopyFallbackStats().elements == 0);
+    }
+    {
+        // ForbidCopyFallback и WarnCopyFallback не мешают типам с noexcept-перемещением
+        using Forbid = CopyFallbackTraits<ForbidCopyFallback>;
+        Vector<Obj, std::allocator<Obj>, Forbid> v;
+        SmallVector<Obj, 2, std::allocator<Obj>, Forbid> small;
+        Devector<Obj, std::allocator<Obj>, Forbid> de;
+        Vector<int, std::allocator<int>, CopyFallbackTraits<WarnCopyFallback>> ints;
+        for (int i = 0; i < 20; ++i) {
+            v.EmplaceBack(i);
+            v.Emplace(v.cbegin(), i);
+            small.EmplaceBack(i);
+            small.Emplace(small.cbegin(), i);
+            de.EmplaceFront(i);
+            de.Emplace(de.cbegin() + 1, i);
+            ints.PushBack(i);
+        }
+        assert(v.Size() == 40 && small.Size() == 40 && de.Size() == 40 && ints.Size() == 20);
+    }
+}
+
+void Test35() {
+    {
+        // Случайные вставки и удаления совпадают с std::set
+        FlatSet<int> flat;
+        std::set<int> reference;
+        uint32_t state = 7;
+        for (int i = 0; i < 2000; ++i) {
+            state = state * 1103515245 + 12345;
+            const int key = static_cast<int>((state >> 8) % 300);
+            if (state % 3 == 0) {
+                assert(flat.Erase(key) == reference.erase(key));
+            } else {
+                const auto [it, inserted] = flat.Insert(key);
+                assert(*it == key && inserted == reference.insert(key).second);
+            }
+            assert(flat.Contains(key) == (reference.count(key) == 1));
+        }
+        assert(flat.Size() == reference.size() && std::equal(flat.begin(), flat.end(), reference.begin()));
+        assert(flat.LowerBound(-1) == flat.begin() && flat.Find(1000) == flat.end());
+        assert(*flat.UpperBound(*flat.begin()) == *std::next(reference.begin()));
+    }
+    {
+        // InsertRange сохраняет ранее хранившиеся ключи и первый из повторов диапазона
+        FlatSet<std::pair<int, int>, std::function<bool(const std::pair<int, int>&, const std::pair<int, int>&)>> flat(
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.first < rhs.first;
+            });
+        flat.Insert({5, 0});
+        flat.Insert({1, 0});
+        const std::vector<std::pair<int, int>> bulk = {{5, 1}, {3, 1}, {9, 1}, {3, 2}, {1, 1}, {7, 1}, {9, 2}};
+        flat.InsertRange(bulk.begin(), bulk.end());
+        const std::vector<std::pair<int, int>> expected = {{1, 0}, {3, 1}, {5, 0}, {7, 1}, {9, 1}};
+        assert(flat.Size() == expected.size() && std::equal(flat.begin(), flat.end(), expected.begin()));
+
+        FlatSet<int> ints;
+        ints.Reserve(64);
+        const int* data = ints.Keys().Data();
+        const std::vector<int> values = {4, 2, 2, 8, 6, 4};
+        ints.InsertRange(values.begin(), values.end());
+        ints.InsertRange(values.begin(), values.end());
+        assert(ints.Keys().Data() == data && ints.Size() == 4);
+        const int* next = ints.Erase(ints.Find(4));
+        assert(*next == 6 && ints.Size() == 3);
+    }
+    {
+        // FlatMap против std::map на случайных операциях
+        FlatMap<int, std::string> flat;
+        std::map<int, std::string> reference;
+        uint32_t state = 11;
+        for (int i = 0; i < 2000; ++i) {
+            state = state * 1103515245 + 12345;
+            const int key = static_cast<int>((state >> 8) % 200);
+            switch (state % 4) {
+            case 0:
+                assert(flat.Erase(key) == reference.erase(key));
+                break;
+            case 1:
+                flat.InsertOrAssign(key, std::to_string(i));
+                reference.insert_or_assign(key, std::to_string(i));
+                break;
+            case 2:
+                flat[key] += "x";
+                reference[key] += "x";
+                break;
+            default:
+                assert(flat.Emplace(key, 3, 'e').second == reference.emplace(key, std::string(3, 'e')).second);
+            }
+        }
+        assert(flat.Size() == reference.size());
+        auto ref_it = reference.begin();
+        for (const auto [key, value] : flat) {
+            assert(key == ref_it->first && value == ref_it->second);
+            ++ref_it;
+        }
+        assert(flat.Keys().Size() == flat.Values().Size());
+    }
+    {
+        // InsertRange, доступ через итераторы и At
+        FlatMap<int, Obj> flat;
+        flat.Emplace(2, 20);
+        const std::vector<std::pair<int, Obj>> bulk = {{4, Obj(40)}, {2, Obj(-1)}, {1, Obj(10)}, {4, Obj(-1)}, {3, Obj(30)}};
+        flat.InsertRange(bulk.begin(), bulk.end());
+        assert(flat.Size() == 4);
+        int expected_key = 1;
+        for (auto it = flat.cbegin(); it != flat.cend(); ++it, ++expected_key) {
+            assert(it->first == expected_key && it->second.id == expected_key * 10);
+            assert(it.Key() == expected_key && (*it).second.id == expected_key * 10);
+        }
+        assert(flat.end() - flat.begin() == 4 && flat.begin()[2].first == 3);
+
+        auto it = flat.Find(3);
+        it->second.id = 33;
+        it.Value().id += 1;
+        assert(flat.At(3).id == 34);
+        const FlatMap<int, Obj>& const_flat = flat;
+        assert(const_flat.Find(5) == const_flat.end() && const_flat.LowerBound(5) == const_flat.end());
+        try {
+            const_flat.At(5);
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+        FlatMap<int, Obj>::const_iterator next = flat.Erase(flat.Find(2));
+        assert(next->first == 3 && flat.Size() == 3 && !flat.Contains(2));
+
+        flat.Reserve(100);
+        assert(flat.Capacity() >= 100);
+        FlatMap<int, Obj> other;
+        other.Swap(flat);
+        assert(flat.Size() == 0 && other.Size() == 3);
+        other.Clear();
+        assert(other.Size() == 0 && other.begin() == other.end());
     }
 }
 
@@ -647,7 +2871,35 @@ int main() {
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
+        Test35();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
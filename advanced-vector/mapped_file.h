@@ -0,0 +1,409 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Подсказки ядру о порядке обращения к отображенному файлу (madvise)
+*/
+enum class MappedAdvice {
+    NORMAL,
+    SEQUENTIAL,     // Последовательное чтение, агрессивное упреждающее чтение
+    RANDOM,         // Произвольный доступ, упреждающее чтение отключается
+    WILL_NEED,      // Заранее подгрузить страницы
+    DONT_NEED,      // Страницы можно вытеснить из памяти
+};
+
+/**
+ * Файл, хранящий массив записей фиксированного размера и отображаемый в память
+ * целиком (MAP_SHARED). Файл начинается с заголовка, в котором записаны размер записи
+ * и количество сохраненных элементов, данные идут со смещения DATA_OFFSET.
+ * Одновременно файл может содержать не больше одного отображения, повторный Map
+ * выбрасывает исключение.
+ * Функции, работающие с файловой системой, при ошибке выбрасывают std::system_error
+*/
+class MappedFile {
+public:
+    // Смещение данных от начала файла, задает и их выравнивание
+    static constexpr size_t DATA_OFFSET = 64;
+
+    MappedFile(const std::string& path, size_t element_size);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() noexcept;
+
+    void* Map(size_t bytes);
+    void* Remap(size_t bytes);
+    void Unmap() noexcept;
+
+    size_t StoredSize() const;
+    void SetStoredSize(size_t size);
+    void Sync();
+
+    void Advise(MappedAdvice advice, size_t offset = 0,
+        size_t length = std::numeric_limits<size_t>::max()) const;
+
+    size_t ElementSize() const noexcept;
+    bool IsMapped() const noexcept;
+    void* MappedData() const noexcept;
+
+private:
+    struct Header {
+        uint64_t magic;
+        uint64_t element_size;
+        uint64_t size;
+    };
+    static_assert(sizeof(Header) <= DATA_OFFSET);
+
+    static constexpr uint64_t MAGIC = 0x31564D4150564441;  // "ADVPAMV1"
+
+    void Grow(size_t file_bytes);
+    [[noreturn]] static void ThrowError(const char* what);
+
+    int fd_ = -1;
+    size_t element_size_ = 0;
+    void* base_ = nullptr;
+    size_t mapped_bytes_ = 0;
+};
+
+/**
+ * Аллокатор, размещающий буфер вектора в отображенном файле. Рост буфера выполняется
+ * через ftruncate и mremap без копирования элементов, поэтому поддерживаются только
+ * тривиально копируемые типы. Если в файле уже есть данные, allocate отображает их
+ * без изменений, что позволяет открыть сохраненный вектор без десериализации.
+ * Файл допускает одно отображение, поэтому такой вектор нельзя копировать
+*/
+template <typename T>
+struct MappedFileAllocator {
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    static_assert(std::is_trivially_copyable_v<T>, "MappedFileAllocator requires trivially copyable T");
+    static_assert(alignof(T) <= MappedFile::DATA_OFFSET, "MappedFileAllocator does not support such alignment");
+
+    static constexpr size_t ALIGNMENT = MappedFile::DATA_OFFSET;
+
+    explicit MappedFileAllocator(std::shared_ptr<MappedFile> file) noexcept
+        : file_(std::move(file))
+    {
+        assert(file_ != nullptr && file_->ElementSize() == sizeof(T));
+    }
+    template <typename U>
+    MappedFileAllocator(const MappedFileAllocator<U>& other) noexcept
+        : file_(other.file_)
+    {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(file_->Map(ByteSize(n)));
+    }
+    void deallocate(T* buf, size_t /*n*/) noexcept {
+        // Блок, не совпадающий с текущим отображением, файлу не принадлежит
+        if (buf != nullptr && buf == file_->MappedData()) {
+            file_->Unmap();
+        }
+    }
+    /**
+     * Увеличивает или уменьшает отображение, содержимое файла сохраняется
+    */
+    T* reallocate(T* buf, size_t /*old_n*/, size_t new_n) {
+        if (buf == nullptr) {
+            return allocate(new_n);
+        }
+        return static_cast<T*>(file_->Remap(ByteSize(new_n)));
+    }
+
+    MappedFile& File() const noexcept {
+        return *file_;
+    }
+
+    template <typename U>
+    bool operator==(const MappedFileAllocator<U>& other) const noexcept {
+        return file_ == other.file_;
+    }
+    template <typename U>
+    bool operator!=(const MappedFileAllocator<U>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    template <typename U>
+    friend struct MappedFileAllocator;
+
+    static size_t ByteSize(size_t n) {
+        if (n > (std::numeric_limits<size_t>::max() - MappedFile::DATA_OFFSET) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    std::shared_ptr<MappedFile> file_;
+};
+
+/**
+ * Вектор в отображенном файле. Файл допускает одно отображение, поэтому вектор только
+ * перемещается; рост буфера всегда выполняется через MappedFileAllocator::reallocate
+*/
+template <typename T, typename Traits = DefaultVectorTraits>
+class MappedVector : public Vector<T, MappedFileAllocator<T>, Traits> {
+    using Base = Vector<T, MappedFileAllocator<T>, Traits>;
+
+public:
+    using Base::Base;
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+    MappedVector(MappedVector&&) noexcept = default;
+    MappedVector& operator=(MappedVector&&) noexcept = default;
+};
+
+/**
+ * Открывает вектор, сохраненный в файле path, или создает пустой. Элементы не читаются:
+ * страницы подгружаются при первом обращении
+*/
+template <typename T, typename Traits = DefaultVectorTraits>
+MappedVector<T, Traits> OpenMappedVector(const std::string& path) {
+    auto file = std::make_shared<MappedFile>(path, sizeof(T));
+    const size_t size = file->StoredSize();
+    // Для тривиальных типов инициализация по умолчанию не затрагивает память
+    return MappedVector<T, Traits>(size, DEFAULT_INIT, MappedFileAllocator<T>(std::move(file)));
+}
+
+/**
+ * Записывает размер вектора в заголовок файла и сбрасывает изменения на диск
+*/
+template <typename T, typename Traits>
+void SyncMappedVector(const MappedVector<T, Traits>& v) {
+    MappedFile& file = v.GetAllocator().File();
+    file.SetStoredSize(v.Size());
+    file.Sync();
+}
+
+/**
+ * Открывает или создает файл. У существующего файла проверяется заголовок
+*/
+inline MappedFile::MappedFile(const std::string& path, size_t element_size)
+    : element_size_(element_size)
+{
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        ThrowError("open");
+    }
+
+    try {
+        struct stat st {};
+        if (::fstat(fd_, &st) != 0) {
+            ThrowError("fstat");
+        }
+
+        Header header{};
+        if (st.st_size == 0) {
+            header = Header{MAGIC, element_size, 0};
+            if (::pwrite(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+                ThrowError("pwrite");
+            }
+            Grow(DATA_OFFSET);
+        }
+        else if (::pread(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+                || header.magic != MAGIC) {
+            throw std::system_error(std::make_error_code(std::errc::invalid_argument), "MappedFile: bad header");
+        }
+        else if (header.element_size != element_size) {
+            throw std::system_error(std::make_error_code(std::errc::invalid_argument), "MappedFile: element size mismatch");
+        }
+    }
+    catch (...) {
+        ::close(fd_);
+        throw;
+    }
+}
+/**
+ * Деструктор, снимает отображение и закрывает файл
+*/
+inline MappedFile::~MappedFile() noexcept {
+    Unmap();
+    ::close(fd_);
+}
+
+/**
+ * Отображает в память заголовок и bytes байт данных, при необходимости увеличивая файл.
+ * Возвращает адрес начала данных. Если файл уже отображен, выбрасывает std::system_error
+*/
+inline void* MappedFile::Map(size_t bytes) {
+    if (IsMapped()) {
+        throw std::system_error(std::make_error_code(std::errc::device_or_resource_busy),
+            "MappedFile: file is already mapped");
+    }
+    const size_t file_bytes = DATA_OFFSET + bytes;
+    Grow(file_bytes);
+
+    void* base = ::mmap(nullptr, file_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) {
+        ThrowError("mmap");
+    }
+    base_ = base;
+    mapped_bytes_ = file_bytes;
+    return static_cast<char*>(base_) + DATA_OFFSET;
+}
+/**
+ * Изменяет размер отображения до bytes байт данных. Отображение может переместиться,
+ * при ошибке прежнее отображение остается действительным
+*/
+inline void* MappedFile::Remap(size_t bytes) {
+    assert(IsMapped());
+    const size_t file_bytes = DATA_OFFSET + bytes;
+    Grow(file_bytes);
+
+#ifdef __linux__
+    void* base = ::mremap(base_, mapped_bytes_, file_bytes, MREMAP_MAYMOVE);
+    if (base == MAP_FAILED) {
+        ThrowError("mremap");
+    }
+#else
+    // Без mremap отображаем файл заново: содержимое хранится в файле, поэтому не теряется
+    void* base = ::mmap(nullptr, file_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) {
+        ThrowError("mmap");
+    }
+    ::munmap(base_, mapped_bytes_);
+#endif
+    base_ = base;
+    mapped_bytes_ = file_bytes;
+    return static_cast<char*>(base_) + DATA_OFFSET;
+}
+/**
+ * Снимает отображение. Данные остаются в файле
+*/
+inline void MappedFile::Unmap() noexcept {
+    if (base_ != nullptr) {
+        ::munmap(base_, mapped_bytes_);
+        base_ = nullptr;
+        mapped_bytes_ = 0;
+    }
+}
+
+/**
+ * Возвращает количество элементов, записанное в заголовке
+*/
+inline size_t MappedFile::StoredSize() const {
+    Header header{};
+    if (::pread(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+        ThrowError("pread");
+    }
+    return static_cast<size_t>(header.size);
+}
+/**
+ * Записывает количество элементов в заголовок
+*/
+inline void MappedFile::SetStoredSize(size_t size) {
+    const uint64_t value = size;
+    if (::pwrite(fd_, &value, sizeof(value), offsetof(Header, size)) != static_cast<ssize_t>(sizeof(value))) {
+        ThrowError("pwrite");
+    }
+}
+/**
+ * Синхронно сбрасывает отображение и файл на диск
+*/
+inline void MappedFile::Sync() {
+    if (IsMapped() && ::msync(base_, mapped_bytes_, MS_SYNC) != 0) {
+        ThrowError("msync");
+    }
+    if (::fsync(fd_) != 0) {
+        ThrowError("fsync");
+    }
+}
+
+/**
+ * Передает ядру подсказку для length байт данных, начиная со смещения offset.
+ * Границы диапазона расширяются до границ страниц
+*/
+inline void MappedFile::Advise(MappedAdvice advice, size_t offset, size_t length) const {
+    if (!IsMapped()) {
+        return;
+    }
+    const size_t data_bytes = mapped_bytes_ - DATA_OFFSET;
+    offset = std::min(offset, data_bytes);
+    length = std::min(length, data_bytes - offset);
+
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t begin = (DATA_OFFSET + offset) / page * page;
+    const size_t end = DATA_OFFSET + offset + length;
+
+    int flag = MADV_NORMAL;
+    switch (advice) {
+    case MappedAdvice::NORMAL:
+        flag = MADV_NORMAL;
+        break;
+    case MappedAdvice::SEQUENTIAL:
+        flag = MADV_SEQUENTIAL;
+        break;
+    case MappedAdvice::RANDOM:
+        flag = MADV_RANDOM;
+        break;
+    case MappedAdvice::WILL_NEED:
+        flag = MADV_WILLNEED;
+        break;
+    case MappedAdvice::DONT_NEED:
+        flag = MADV_DONTNEED;
+        break;
+    }
+    if (::madvise(static_cast<char*>(base_) + begin, end - begin, flag) != 0) {
+        ThrowError("madvise");
+    }
+}
+
+/**
+ * Возвращает размер записи, с которым создан файл
+*/
+inline size_t MappedFile::ElementSize() const noexcept {
+    return element_size_;
+}
+/**
+ * Проверяет наличие отображения
+*/
+inline bool MappedFile::IsMapped() const noexcept {
+    return base_ != nullptr;
+}
+/**
+ * Возвращает адрес данных в текущем отображении или nullptr
+*/
+inline void* MappedFile::MappedData() const noexcept {
+    return base_ != nullptr ? static_cast<char*>(base_) + DATA_OFFSET : nullptr;
+}
+
+/**
+ * Увеличивает файл до file_bytes байт. Файл никогда не уменьшается, чтобы не терять данные
+*/
+inline void MappedFile::Grow(size_t file_bytes) {
+    struct stat st {};
+    if (::fstat(fd_, &st) != 0) {
+        ThrowError("fstat");
+    }
+    if (static_cast<size_t>(st.st_size) < file_bytes
+            && ::ftruncate(fd_, static_cast<off_t>(file_bytes)) != 0) {
+        ThrowError("ftruncate");
+    }
+}
+/**
+ * Выбрасывает std::system_error с кодом из errno
+*/
+inline void MappedFile::ThrowError(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * Политика выполнения массовых операций вектора в нескольких потоках. Диапазон делится
+ * на части не короче MinChunk элементов, но не больше чем на MaxThreads частей
+ * (0 — по числу аппаратных потоков). Первая часть выполняется вызывающим потоком.
+ * Подключается через Traits вектора:
+ *
+ *     struct ParallelTraits : DefaultVectorTraits {
+ *         using ExecutionPolicy = ParallelExecution<>;
+ *     };
+ *     Vector<std::string, std::allocator<std::string>, ParallelTraits> v(100'000'000);
+ *
+ * Конструктор копирования, конструкторы с размером, перенос элементов при переаллокации,
+ * Clear и деструктор выполняются параллельно. Типы элементов должны допускать
+ * одновременное конструирование и разрушение разных объектов из разных потоков
+*/
+template <size_t MinChunk = 1 << 16, size_t MaxThreads = 0>
+struct ParallelExecution {
+    static_assert(MinChunk > 0, "ParallelExecution requires positive chunk size");
+
+    static size_t ChunkCount(size_t count) noexcept {
+        size_t threads = MaxThreads;
+        if constexpr (MaxThreads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        return std::clamp<size_t>(count / MinChunk, 1, threads);
+    }
+
+    template <typename Task>
+    static void Run(size_t chunks, Task& task) noexcept {
+        std::vector<std::thread> threads;
+        size_t chunk = 1;
+        try {
+            threads.reserve(chunks - 1);
+            for (; chunk < chunks; ++chunk) {
+                threads.emplace_back([&task, chunk] {
+                    task(chunk);
+                });
+            }
+        }
+        catch (...) {
+            // Потоки создать не удалось - оставшиеся части выполняем в вызывающем потоке
+            for (; chunk < chunks; ++chunk) {
+                task(chunk);
+            }
+        }
+        task(0);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+};
@@ -0,0 +1,500 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Вектор из сегментов геометрически растущего размера: сегмент k вмещает
+ * FIRST_SEGMENT_SIZE * 2^k элементов. При росте выделяется новый сегмент, а существующие
+ * элементы не переносятся, поэтому добавление не копирует и не перемещает их, а адреса
+ * элементов стабильны до удаления. Индекс раскладывается на сегмент и смещение за O(1).
+ * Для потребителей, которым нужен непрерывный буфер, служит Flatten()
+*/
+template <typename T, typename Alloc = std::allocator<T>>
+class SegmentedVector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Layout = detail::SegmentLayout<4>;
+    using Segment = RawMemory<T, Alloc>;
+    using SegmentAlloc = typename AllocTraits::template rebind_alloc<Segment>;
+
+    template <bool IsConst>
+    class BasicIterator;
+
+public:
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+    using allocator_type = Alloc;
+    using VectorType = Vector<T, Alloc>;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+        "SegmentedVector<T, Alloc> requires Alloc::value_type to be T");
+
+    static constexpr size_t FIRST_SEGMENT_SIZE = Layout::FIRST_SIZE;
+
+    SegmentedVector() noexcept(noexcept(Alloc()));
+    explicit SegmentedVector(const Alloc& alloc) noexcept;
+    SegmentedVector(const SegmentedVector& other);
+    SegmentedVector(SegmentedVector&& other) noexcept;
+
+    SegmentedVector& operator=(const SegmentedVector& other);
+    SegmentedVector& operator=(SegmentedVector&& other) noexcept;
+
+    ~SegmentedVector() noexcept;
+
+    void Reserve(size_t n);
+    void ShrinkToFit() noexcept;
+    void Clear() noexcept;
+
+    template <typename... Types>
+    T& EmplaceBack(Types&&... args);
+    template <typename ValueType>
+    void PushBack(ValueType&& value);
+    void PopBack() noexcept;
+
+    size_t Size() const noexcept;
+    size_t Capacity() const noexcept;
+    size_t SegmentCount() const noexcept;
+
+    const T& operator[](size_t index) const noexcept;
+    T& operator[](size_t index) noexcept;
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    template <typename Function>
+    void ForEachSegment(Function f);
+    template <typename Function>
+    void ForEachSegment(Function f) const;
+
+    VectorType Flatten() const&;
+    VectorType Flatten() &&;
+
+    void Swap(SegmentedVector& other) noexcept;
+
+    Alloc GetAllocator() const noexcept;
+
+private:
+    Alloc alloc_;
+    Vector<Segment, SegmentAlloc> segments_; // Выделенные сегменты, последние могут быть пустыми
+    size_t size_ = 0; // Размер вектора
+
+    void AddSegment();
+};
+
+/**
+ * Итератор произвольного доступа: хранит индекс элемента и раскладывает его
+ * на сегмент и смещение при разыменовании
+*/
+template <typename T, typename Alloc>
+template <bool IsConst>
+class SegmentedVector<T, Alloc>::BasicIterator {
+    using Container = std::conditional_t<IsConst, const SegmentedVector, SegmentedVector>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IsConst, const T*, T*>;
+    using reference = std::conditional_t<IsConst, const T&, T&>;
+
+    BasicIterator() = default;
+    BasicIterator(Container* container, size_t index) noexcept
+        : container_(container)
+        , index_(index)
+    {}
+    // Неконстантный итератор преобразуется в константный
+    template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+    BasicIterator(const BasicIterator<OtherConst>& other) noexcept
+        : container_(other.container_)
+        , index_(other.index_)
+    {}
+
+    reference operator*() const noexcept {
+        return (*container_)[index_];
+    }
+    pointer operator->() const noexcept {
+        return std::addressof(**this);
+    }
+    reference operator[](difference_type offset) const noexcept {
+        return (*container_)[index_ + offset];
+    }
+
+    BasicIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+    BasicIterator operator++(int) noexcept {
+        BasicIterator old = *this;
+        ++index_;
+        return old;
+    }
+    BasicIterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+    BasicIterator operator--(int) noexcept {
+        BasicIterator old = *this;
+        --index_;
+        return old;
+    }
+    BasicIterator& operator+=(difference_type offset) noexcept {
+        index_ += offset;
+        return *this;
+    }
+    BasicIterator& operator-=(difference_type offset) noexcept {
+        index_ -= offset;
+        return *this;
+    }
+
+    friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+    friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+        return it += offset;
+    }
+    friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+        return it -= offset;
+    }
+    friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+    friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ != rhs.index_;
+    }
+    friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ < rhs.index_;
+    }
+    friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ > rhs.index_;
+    }
+    friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ <= rhs.index_;
+    }
+    friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ >= rhs.index_;
+    }
+
+private:
+    template <bool>
+    friend class BasicIterator;
+
+    Container* container_ = nullptr;
+    size_t index_ = 0;
+};
+
+/**
+ * Конструктор по умолчанию
+*/
+template <typename T, typename Alloc>
+SegmentedVector<T, Alloc>::SegmentedVector() noexcept(noexcept(Alloc()))
+    : alloc_()
+    , segments_(SegmentAlloc(alloc_))
+{}
+/**
+ * Конструктор, создает пустой вектор, использующий заданный аллокатор
+*/
+template <typename T, typename Alloc>
+SegmentedVector<T, Alloc>::SegmentedVector(const Alloc& alloc) noexcept
+    : alloc_(alloc)
+    , segments_(SegmentAlloc(alloc_))
+{}
+/**
+ * Конструктор, создает копию передаваемого вектора. Сегменты копии имеют
+ * те же размеры, поэтому элементы копируются сегментами целиком
+*/
+template <typename T, typename Alloc>
+SegmentedVector<T, Alloc>::SegmentedVector(const SegmentedVector& other)
+    : SegmentedVector(AllocTraits::select_on_container_copy_construction(other.alloc_))
+{
+    Reserve(other.size_);
+    size_t segment = 0;
+    other.ForEachSegment([this, &segment](const T* data, size_t n) {
+        std::uninitialized_copy_n(data, n, segments_[segment].GetAddress());
+        size_ += n;
+        ++segment;
+    });
+}
+/**
+ * Конструктор перемещения
+*/
+template <typename T, typename Alloc>
+SegmentedVector<T, Alloc>::SegmentedVector(SegmentedVector&& other) noexcept
+    : alloc_(other.alloc_)
+    , segments_(std::move(other.segments_))
+    , size_(std::exchange(other.size_, 0))
+{}
+
+/**
+ * Оператор копирующего присваивания, применяет идиому copy-and-swap
+*/
+template <typename T, typename Alloc>
+SegmentedVector<T, Alloc>& SegmentedVector<T, Alloc>::operator=(const SegmentedVector& other) {
+    if (this != &other) {
+        SegmentedVector copy(other);
+        Swap(copy);
+    }
+    return *this;
+}
+/**
+ * Оператор перемещающего присваивания
+*/
+template <typename T, typename Alloc>
+SegmentedVector<T, Alloc>& SegmentedVector<T, Alloc>::operator=(SegmentedVector&& other) noexcept {
+    SegmentedVector moved(std::move(other));
+    Swap(moved);
+    return *this;
+}
+
+/**
+ * Деструктор, вызывает деструкторы хранящихся в векторе объектов,
+ * сегменты освобождаются деструктором segments_
+*/
+template <typename T, typename Alloc>
+SegmentedVector<T, Alloc>::~SegmentedVector() noexcept {
+    Clear();
+}
+
+/**
+ * Выделяет сегменты, необходимые для хранения n элементов
+*/
+template <typename T, typename Alloc>
+void SegmentedVector<T, Alloc>::Reserve(size_t n) {
+    while (Capacity() < n) {
+        AddSegment();
+    }
+}
+/**
+ * Освобождает сегменты, не содержащие элементов
+*/
+template <typename T, typename Alloc>
+void SegmentedVector<T, Alloc>::ShrinkToFit() noexcept {
+    const size_t used = size_ == 0 ? 0 : Layout::SegmentIndex(size_ - 1) + 1;
+    while (segments_.Size() > used) {
+        segments_.PopBack();
+    }
+}
+/**
+ * Удаляет все элементы вектора, сохраняя выделенные сегменты
+*/
+template <typename T, typename Alloc>
+void SegmentedVector<T, Alloc>::Clear() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        ForEachSegment([](T* data, size_t n) {
+            std::destroy_n(data, n);
+        });
+    }
+    size_ = 0;
+}
+
+/**
+ * Передает аргументы конструктору типа T по forwarding-ссылке, полученный элемент
+ * добавляется в конец вектора. Существующие элементы не переносятся, поэтому
+ * аргументы могут ссылаться на них
+*/
+template <typename T, typename Alloc>
+template <typename... Types>
+T& SegmentedVector<T, Alloc>::EmplaceBack(Types&&... args) {
+    const size_t segment = Layout::SegmentIndex(size_);
+    if (segment == segments_.Size()) {
+        AddSegment();
+    }
+    T* slot = segments_[segment] + Layout::SegmentOffset(size_, segment);
+    new (slot) T(std::forward<Types>(args)...);
+    ++size_;
+    return *slot;
+}
+/**
+ * Копирует или перемещает передаваемый элемент в конец вектора
+*/
+template <typename T, typename Alloc>
+template <typename ValueType>
+void SegmentedVector<T, Alloc>::PushBack(ValueType&& value) {
+    EmplaceBack(std::forward<ValueType>(value));
+}
+/**
+ * Удаляет из вектора последний элемент
+*/
+template <typename T, typename Alloc>
+void SegmentedVector<T, Alloc>::PopBack() noexcept {
+    assert(size_ > 0);
+    std::destroy_at(std::addressof((*this)[size_ - 1]));
+    --size_;
+}
+
+/**
+ * Возвращает размер вектора
+*/
+template <typename T, typename Alloc>
+size_t SegmentedVector<T, Alloc>::Size() const noexcept {
+    return size_;
+}
+/**
+ * Возвращает суммарную вместимость выделенных сегментов
+*/
+template <typename T, typename Alloc>
+size_t SegmentedVector<T, Alloc>::Capacity() const noexcept {
+    // Сегменты 0..k-1 вмещают FIRST_SEGMENT_SIZE * (2^k - 1) элементов
+    return segments_.Size() == 0 ? 0 : Layout::SegmentSize(segments_.Size()) - FIRST_SEGMENT_SIZE;
+}
+/**
+ * Возвращает количество выделенных сегментов
+*/
+template <typename T, typename Alloc>
+size_t SegmentedVector<T, Alloc>::SegmentCount() const noexcept {
+    return segments_.Size();
+}
+
+/**
+ * Константная ссылка на элемент вектора
+*/
+template <typename T, typename Alloc>
+const T& SegmentedVector<T, Alloc>::operator[](size_t index) const noexcept {
+    assert(index < size_);
+    const size_t segment = Layout::SegmentIndex(index);
+    return segments_[segment][Layout::SegmentOffset(index, segment)];
+}
+/**
+ * Ссылка на элемент вектора
+*/
+template <typename T, typename Alloc>
+T& SegmentedVector<T, Alloc>::operator[](size_t index) noexcept {
+    return const_cast<T&>(std::as_const(*this)[index]);
+}
+
+/**
+ * Возвращает итератор на начало вектора
+*/
+template <typename T, typename Alloc>
+typename SegmentedVector<T, Alloc>::iterator SegmentedVector<T, Alloc>::begin() noexcept {
+    return iterator(this, 0);
+}
+/**
+ * Возвращает итератор на конец вектора
+*/
+template <typename T, typename Alloc>
+typename SegmentedVector<T, Alloc>::iterator SegmentedVector<T, Alloc>::end() noexcept {
+    return iterator(this, size_);
+}
+/**
+ * Возвращает константный итератор на начало вектора
+*/
+template <typename T, typename Alloc>
+typename SegmentedVector<T, Alloc>::const_iterator SegmentedVector<T, Alloc>::begin() const noexcept {
+    return const_iterator(this, 0);
+}
+/**
+ * Возвращает константный итератор на конец вектора
+*/
+template <typename T, typename Alloc>
+typename SegmentedVector<T, Alloc>::const_iterator SegmentedVector<T, Alloc>::end() const noexcept {
+    return const_iterator(this, size_);
+}
+/**
+ * Возвращает константный итератор на начало вектора
+*/
+template <typename T, typename Alloc>
+typename SegmentedVector<T, Alloc>::const_iterator SegmentedVector<T, Alloc>::cbegin() const noexcept {
+    return begin();
+}
+/**
+ * Возвращает константный итератор на конец вектора
+*/
+template <typename T, typename Alloc>
+typename SegmentedVector<T, Alloc>::const_iterator SegmentedVector<T, Alloc>::cend() const noexcept {
+    return end();
+}
+
+/**
+ * Вызывает f(T* data, size_t n) для непрерывных частей вектора по порядку.
+ * Обход по сегментам не вычисляет сегмент для каждого элемента
+*/
+template <typename T, typename Alloc>
+template <typename Function>
+void SegmentedVector<T, Alloc>::ForEachSegment(Function f) {
+    size_t rest = size_;
+    for (size_t segment = 0; rest != 0; ++segment) {
+        const size_t n = std::min(rest, Layout::SegmentSize(segment));
+        f(segments_[segment].GetAddress(), n);
+        rest -= n;
+    }
+}
+/**
+ * Вызывает f(const T* data, size_t n) для непрерывных частей вектора по порядку
+*/
+template <typename T, typename Alloc>
+template <typename Function>
+void SegmentedVector<T, Alloc>::ForEachSegment(Function f) const {
+    size_t rest = size_;
+    for (size_t segment = 0; rest != 0; ++segment) {
+        const size_t n = std::min(rest, Layout::SegmentSize(segment));
+        f(segments_[segment].GetAddress(), n);
+        rest -= n;
+    }
+}
+
+/**
+ * Копирует элементы в непрерывный вектор
+*/
+template <typename T, typename Alloc>
+typename SegmentedVector<T, Alloc>::VectorType SegmentedVector<T, Alloc>::Flatten() const& {
+    VectorType result(alloc_);
+    result.Reserve(size_);
+    ForEachSegment([&result](const T* data, size_t n) {
+        result.AppendRange(data, data + n);
+    });
+    return result;
+}
+/**
+ * Перемещает элементы в непрерывный вектор, оставляя этот вектор пустым
+*/
+template <typename T, typename Alloc>
+typename SegmentedVector<T, Alloc>::VectorType SegmentedVector<T, Alloc>::Flatten() && {
+    VectorType result(alloc_);
+    result.Reserve(size_);
+    ForEachSegment([&result](T* data, size_t n) {
+        result.AppendRange(std::make_move_iterator(data), std::make_move_iterator(data + n));
+    });
+    Clear();
+    return result;
+}
+
+/**
+ * Обменивает содержимое векторов
+*/
+template <typename T, typename Alloc>
+void SegmentedVector<T, Alloc>::Swap(SegmentedVector& other) noexcept {
+    std::swap(alloc_, other.alloc_);
+    segments_.Swap(other.segments_);
+    std::swap(size_, other.size_);
+}
+
+/**
+ * Возвращает копию аллокатора вектора
+*/
+template <typename T, typename Alloc>
+Alloc SegmentedVector<T, Alloc>::GetAllocator() const noexcept {
+    return alloc_;
+}
+
+/**
+ * Выделяет следующий сегмент
+*/
+template <typename T, typename Alloc>
+void SegmentedVector<T, Alloc>::AddSegment() {
+    assert(segments_.Size() < Layout::MAX_SEGMENTS);
+    segments_.EmplaceBack(Layout::SegmentSize(segments_.Size()), alloc_);
+}
@@ -0,0 +1,474 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Набор векторных инструкций, которым выполняются алгоритмы этого заголовка.
+ * Уровень определяется при первом вызове по возможностям процессора
+*/
+enum class SimdLevel {
+    SCALAR,     // Обычные циклы std::
+    SSE2,       // 16-байтные регистры x86
+    AVX2,       // 32-байтные регистры x86
+    AVX512,     // 64-байтные регистры x86 (AVX-512F)
+    NEON,       // 16-байтные регистры ARM
+};
+
+// Ядра используют расширения GCC и Clang для векторных типов
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__) || defined(__ARM_NEON))
+#define ADVANCED_VECTOR_SIMD 1
+#endif
+
+namespace detail {
+
+/**
+ * Определяет старший набор инструкций, поддерживаемый процессором
+*/
+inline SimdLevel DetectSimdLevel() noexcept {
+#if defined(ADVANCED_VECTOR_SIMD) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::SSE2;
+    }
+#elif defined(ADVANCED_VECTOR_SIMD)
+    return SimdLevel::NEON;
+#endif
+    return SimdLevel::SCALAR;
+}
+
+inline std::atomic<SimdLevel>& SimdLevelStorage() noexcept {
+    static std::atomic<SimdLevel> level{DetectSimdLevel()};
+    return level;
+}
+
+// Векторные ядра написаны для 4- и 8-байтных элементов, остальные типы обрабатываются циклами std::
+template <typename T>
+inline constexpr bool SIMD_ELEMENT = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>
+    && (sizeof(T) == 4 || sizeof(T) == 8);
+
+#ifdef ADVANCED_VECTOR_SIMD
+
+template <typename T, size_t Bytes>
+struct PackOf {
+    typedef T Type __attribute__((vector_size(Bytes)));
+};
+
+// Регистр из Bytes / sizeof(T) элементов
+template <typename T, size_t Bytes>
+using Pack = typename PackOf<T, Bytes>::Type;
+
+// Загружает регистр по невыровненному адресу. Регистр передается по ссылке: возврат
+// 32- и 64-байтных векторов по значению зависит от ABI набора инструкций
+template <typename V>
+[[gnu::always_inline]] inline void LoadPack(V& pack, const void* address) noexcept {
+    std::memcpy(&pack, address, sizeof(V));
+}
+
+// Проверяет, что хотя бы одна дорожка маски сравнения установлена
+template <typename M>
+[[gnu::always_inline]] inline bool AnyLane(const M& mask) noexcept {
+    uint64_t words[sizeof(M) / sizeof(uint64_t)];
+    std::memcpy(words, &mask, sizeof(M));
+    uint64_t any = 0;
+    for (uint64_t word : words) {
+        any |= word;
+    }
+    return any != 0;
+}
+
+/**
+ * Функции Run<Bytes> ядер используют GCC vector extensions и встраиваются в обертки,
+ * скомпилированные для конкретного набора инструкций, поэтому один исходный текст
+ * дает код для SSE2, AVX2, AVX-512 и NEON
+*/
+
+template <typename T>
+struct FindKernel {
+    const T* data;
+    size_t size;
+    T value;
+
+    size_t Scalar() const noexcept {
+        return std::find(data, data + size, value) - data;
+    }
+    template <size_t Bytes>
+    [[gnu::always_inline]] size_t Run() const noexcept {
+        using V = Pack<T, Bytes>;
+        constexpr size_t LANES = Bytes / sizeof(T);
+        const V needle = V{} + value;
+        size_t i = 0;
+        for (; i + LANES <= size; i += LANES) {
+            V pack;
+            LoadPack(pack, data + i);
+            if (AnyLane(pack == needle)) {
+                break;
+            }
+        }
+        // Позиция внутри найденного регистра или в хвосте
+        for (; i < size; ++i) {
+            if (data[i] == value) {
+                return i;
+            }
+        }
+        return size;
+    }
+};
+
+template <typename T>
+struct CountKernel {
+    const T* data;
+    size_t size;
+    T value;
+
+    size_t Scalar() const noexcept {
+        return std::count(data, data + size, value);
+    }
+    template <size_t Bytes>
+    [[gnu::always_inline]] size_t Run() const noexcept {
+        using V = Pack<T, Bytes>;
+        using Mask = decltype(V{} == V{});
+        constexpr size_t LANES = Bytes / sizeof(T);
+        // Счетчики дорожек сбрасываются в результат раньше, чем могут переполниться
+        constexpr size_t BLOCK = size_t{1} << 30;
+        const V needle = V{} + value;
+        size_t result = 0;
+        size_t i = 0;
+        while (i + LANES <= size) {
+            const size_t block_end = i + std::min((size - i) / LANES, BLOCK) * LANES;
+            Mask counters{};
+            for (; i < block_end; i += LANES) {
+                V pack;
+                LoadPack(pack, data + i);
+                // Совпавшие дорожки маски равны -1
+                counters -= pack == needle;
+            }
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                result += static_cast<size_t>(counters[lane]);
+            }
+        }
+        for (; i < size; ++i) {
+            result += data[i] == value;
+        }
+        return result;
+    }
+};
+
+template <typename T>
+struct MinMaxKernel {
+    const T* data;
+    size_t size;
+
+    std::pair<T, T> Scalar() const noexcept {
+        const auto [min, max] = std::minmax_element(data, data + size);
+        return {*min, *max};
+    }
+    template <size_t Bytes>
+    [[gnu::always_inline]] std::pair<T, T> Run() const noexcept {
+        using V = Pack<T, Bytes>;
+        constexpr size_t LANES = Bytes / sizeof(T);
+        T min = data[0];
+        T max = data[0];
+        size_t i = 0;
+        if (size >= LANES) {
+            V min_pack;
+            LoadPack(min_pack, data);
+            V max_pack = min_pack;
+            for (i = LANES; i + LANES <= size; i += LANES) {
+                V pack;
+                LoadPack(pack, data + i);
+                min_pack = pack < min_pack ? pack : min_pack;
+                max_pack = max_pack < pack ? pack : max_pack;
+            }
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                min = min_pack[lane] < min ? min_pack[lane] : min;
+                max = max < max_pack[lane] ? max_pack[lane] : max;
+            }
+        }
+        for (; i < size; ++i) {
+            min = data[i] < min ? data[i] : min;
+            max = max < data[i] ? data[i] : max;
+        }
+        return {min, max};
+    }
+};
+
+template <typename T, bool = std::is_integral_v<T>>
+struct SumAccumulator {
+    using type = T;
+};
+template <typename T>
+struct SumAccumulator<T, true> {
+    using type = std::make_unsigned_t<T>;
+};
+
+template <typename T>
+struct SumKernel {
+    const T* data;
+    size_t size;
+
+    // Целые складываются по модулю 2^N, как беззнаковые
+    using Accumulator = typename SumAccumulator<T>::type;
+
+    T Scalar() const noexcept {
+        return static_cast<T>(std::accumulate(data, data + size, Accumulator{}));
+    }
+    template <size_t Bytes>
+    [[gnu::always_inline]] T Run() const noexcept {
+        using V = Pack<Accumulator, Bytes>;
+        constexpr size_t LANES = Bytes / sizeof(T);
+        // Четыре независимых суммы скрывают задержку сложения
+        V sums[4] = {};
+        size_t i = 0;
+        for (; i + 4 * LANES <= size; i += 4 * LANES) {
+            for (size_t k = 0; k < 4; ++k) {
+                V pack;
+                LoadPack(pack, data + i + k * LANES);
+                sums[k] += pack;
+            }
+        }
+        for (; i + LANES <= size; i += LANES) {
+            V pack;
+            LoadPack(pack, data + i);
+            sums[0] += pack;
+        }
+        const V total = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        Accumulator result{};
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            result += total[lane];
+        }
+        for (; i < size; ++i) {
+            result += static_cast<Accumulator>(data[i]);
+        }
+        return static_cast<T>(result);
+    }
+};
+
+template <typename T>
+struct EqualKernel {
+    const T* lhs;
+    const T* rhs;
+    size_t size;
+
+    bool Scalar() const noexcept {
+        return std::equal(lhs, lhs + size, rhs);
+    }
+    template <size_t Bytes>
+    [[gnu::always_inline]] bool Run() const noexcept {
+        using V = Pack<T, Bytes>;
+        constexpr size_t LANES = Bytes / sizeof(T);
+        size_t i = 0;
+        for (; i + LANES <= size; i += LANES) {
+            // Сравнение элементов, а не байт: -0.0 == 0.0, NaN не равен себе
+            V lhs_pack;
+            V rhs_pack;
+            LoadPack(lhs_pack, lhs + i);
+            LoadPack(rhs_pack, rhs + i);
+            if (AnyLane(lhs_pack != rhs_pack)) {
+                return false;
+            }
+        }
+        for (; i < size; ++i) {
+            if (!(lhs[i] == rhs[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template <typename T>
+struct FillKernel {
+    T* data;
+    size_t size;
+    T value;
+
+    bool Scalar() const noexcept {
+        std::fill_n(data, size, value);
+        return true;
+    }
+    template <size_t Bytes>
+    [[gnu::always_inline]] bool Run() const noexcept {
+        using V = Pack<T, Bytes>;
+        constexpr size_t LANES = Bytes / sizeof(T);
+        const V pack = V{} + value;
+        size_t i = 0;
+        for (; i + LANES <= size; i += LANES) {
+            std::memcpy(data + i, &pack, sizeof(V));
+        }
+        for (; i < size; ++i) {
+            data[i] = value;
+        }
+        return true;
+    }
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+template <typename Kernel>
+__attribute__((target("sse2"))) auto RunSse2(const Kernel& kernel) noexcept {
+    return kernel.template Run<16>();
+}
+template <typename Kernel>
+__attribute__((target("avx2"))) auto RunAvx2(const Kernel& kernel) noexcept {
+    return kernel.template Run<32>();
+}
+template <typename Kernel>
+__attribute__((target("avx512f"))) auto RunAvx512(const Kernel& kernel) noexcept {
+    return kernel.template Run<64>();
+}
+#endif
+
+#endif // ADVANCED_VECTOR_SIMD
+
+/**
+ * Выполняет ядро набором инструкций текущего уровня
+*/
+template <typename Kernel>
+auto RunKernel(const Kernel& kernel) noexcept {
+#ifdef ADVANCED_VECTOR_SIMD
+    switch (SimdLevelStorage().load(std::memory_order_relaxed)) {
+#if defined(__x86_64__) || defined(__i386__)
+    case SimdLevel::AVX512:
+        return RunAvx512(kernel);
+    case SimdLevel::AVX2:
+        return RunAvx2(kernel);
+    case SimdLevel::SSE2:
+        return RunSse2(kernel);
+#else
+    case SimdLevel::NEON:
+        return kernel.template Run<16>();
+#endif
+    default:
+        break;
+    }
+#endif
+    return kernel.Scalar();
+}
+
+} // namespace detail
+
+/**
+ * Возвращает набор инструкций, которым выполняются алгоритмы
+*/
+inline SimdLevel GetSimdLevel() noexcept {
+    return detail::SimdLevelStorage().load(std::memory_order_relaxed);
+}
+/**
+ * Ограничивает набор инструкций уровнем level (для тестов и замеров).
+ * Уровень не поднимается выше поддерживаемого процессором, возвращает установленный уровень
+*/
+inline SimdLevel SetSimdLevel(SimdLevel level) noexcept {
+    const SimdLevel detected = detail::DetectSimdLevel();
+    // NEON старше всех уровней x86 и потому не проходит проверку level <= detected на x86
+    const bool supported = level == SimdLevel::SCALAR || level == detected
+        || (detected != SimdLevel::NEON && level <= detected);
+    if (!supported) {
+        level = detected;
+    }
+    detail::SimdLevelStorage().store(level, std::memory_order_relaxed);
+    return level;
+}
+
+/**
+ * Возвращает итератор на первый элемент, равный value, или end()
+*/
+template <typename T, typename Alloc, typename Traits>
+typename Vector<T, Alloc, Traits>::const_iterator Find(const Vector<T, Alloc, Traits>& v, const T& value) {
+    if constexpr (detail::SIMD_ELEMENT<T>) {
+        return v.begin() + detail::RunKernel(detail::FindKernel<T>{v.Data(), v.Size(), value});
+    }
+    else {
+        return std::find(v.begin(), v.end(), value);
+    }
+}
+/**
+ * Возвращает итератор на первый элемент, равный value, или end()
+*/
+template <typename T, typename Alloc, typename Traits>
+typename Vector<T, Alloc, Traits>::iterator Find(Vector<T, Alloc, Traits>& v, const T& value) {
+    return v.begin() + (Find(std::as_const(v), value) - v.cbegin());
+}
+/**
+ * Возвращает количество элементов, равных value
+*/
+template <typename T, typename Alloc, typename Traits>
+size_t Count(const Vector<T, Alloc, Traits>& v, const T& value) {
+    if constexpr (detail::SIMD_ELEMENT<T>) {
+        return detail::RunKernel(detail::CountKernel<T>{v.Data(), v.Size(), value});
+    }
+    else {
+        return std::count(v.begin(), v.end(), value);
+    }
+}
+/**
+ * Возвращает наименьший и наибольший элементы. Для пустого вектора
+ * выбрасывает std::invalid_argument
+*/
+template <typename T, typename Alloc, typename Traits>
+std::pair<T, T> MinMax(const Vector<T, Alloc, Traits>& v) {
+    if (v.Size() == 0) {
+        throw std::invalid_argument("MinMax of empty vector");
+    }
+    if constexpr (detail::SIMD_ELEMENT<T>) {
+        return detail::RunKernel(detail::MinMaxKernel<T>{v.Data(), v.Size()});
+    }
+    else {
+        const auto [min, max] = std::minmax_element(v.begin(), v.end());
+        return {*min, *max};
+    }
+}
+/**
+ * Возвращает сумму элементов. Целые складываются по модулю 2^N; сумма чисел
+ * с плавающей точкой накапливается по дорожкам и может отличаться от
+ * последовательного сложения в младших разрядах
+*/
+template <typename T, typename Alloc, typename Traits>
+T Sum(const Vector<T, Alloc, Traits>& v) {
+    if constexpr (detail::SIMD_ELEMENT<T>) {
+        return detail::RunKernel(detail::SumKernel<T>{v.Data(), v.Size()});
+    }
+    else {
+        return std::accumulate(v.begin(), v.end(), T{});
+    }
+}
+/**
+ * Проверяет, что векторы имеют одинаковый размер и равные элементы
+*/
+template <typename T, typename Alloc, typename Traits, typename OtherAlloc, typename OtherTraits>
+bool Equal(const Vector<T, Alloc, Traits>& lhs, const Vector<T, OtherAlloc, OtherTraits>& rhs) {
+    if (lhs.Size() != rhs.Size()) {
+        return false;
+    }
+    if constexpr (detail::SIMD_ELEMENT<T>) {
+        return detail::RunKernel(detail::EqualKernel<T>{lhs.Data(), rhs.Data(), lhs.Size()});
+    }
+    else {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+}
+/**
+ * Присваивает всем элементам значение value
+*/
+template <typename T, typename Alloc, typename Traits>
+void Fill(Vector<T, Alloc, Traits>& v, const T& value) {
+    if constexpr (detail::SIMD_ELEMENT<T>) {
+        detail::RunKernel(detail::FillKernel<T>{v.Data(), v.Size(), value});
+    }
+    else {
+        std::fill(v.begin(), v.end(), value);
+    }
+}
@@ -0,0 +1,484 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Вектор с оптимизацией малого буфера: первые N элементов хранятся внутри объекта,
+ * динамическая память выделяется только при превышении этого количества.
+ * После перехода в динамическую память вектор в малый буфер не возвращается
+*/
+template <typename T, size_t N, typename Alloc = std::allocator<T>, typename Traits = DefaultVectorTraits>
+class SmallVector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+
+    static_assert(N > 0, "SmallVector requires positive inline capacity");
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+        "SmallVector<T, N, Alloc> requires Alloc::value_type to be T");
+
+    static constexpr size_t INLINE_CAPACITY = N;
+
+    SmallVector() noexcept(noexcept(Alloc()));
+    explicit SmallVector(const Alloc& alloc) noexcept;
+    explicit SmallVector(size_t size, const Alloc& alloc = Alloc());
+    SmallVector(const SmallVector& other);
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    SmallVector& operator=(const SmallVector& other);
+    SmallVector& operator=(SmallVector&& other) noexcept(
+        std::is_nothrow_move_constructible_v<T> && AllocTraits::is_always_equal::value);
+
+    ~SmallVector() noexcept;
+
+    void Resize(size_t new_size);
+    void Reserve(size_t n);
+
+    template <typename... Types>
+    T& EmplaceBack(Types&&... args);
+    template <typename ValueType>
+    void PushBack(ValueType&& value);
+
+    template <typename... Types>
+    iterator Emplace(const_iterator pos, Types&&... args);
+    template <typename ValueType>
+    iterator Insert(const_iterator pos, ValueType&& value);
+
+    void PopBack() noexcept;
+    iterator Erase(const_iterator pos);
+
+    size_t Size() const noexcept;
+    size_t Capacity() const noexcept;
+    bool IsInline() const noexcept;
+
+    const T& operator[](size_t index) const noexcept;
+    T& operator[](size_t index) noexcept;
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    void Swap(SmallVector& other) noexcept(
+        std::is_nothrow_move_constructible_v<T> && AllocTraits::is_always_equal::value);
+
+    Alloc GetAllocator() const noexcept;
+
+private:
+    alignas(T) unsigned char storage_[N * sizeof(T)]; // Малый буфер под N элементов
+    RawMemory<T, Alloc> heap_; // Динамическая память, пуста пока элементы в малом буфере
+    size_t size_ = 0; // Размер вектора
+
+    T* Data() noexcept;
+    const T* Data() const noexcept;
+
+    size_t NextCapacity(size_t required) const noexcept;
+};
+
+/**
+ * Конструктор по умолчанию
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+SmallVector<T, N, Alloc, Traits>::SmallVector() noexcept(noexcept(Alloc()))
+    : heap_()
+{}
+/**
+ * Конструктор, создает пустой вектор, использующий заданный аллокатор
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+SmallVector<T, N, Alloc, Traits>::SmallVector(const Alloc& alloc) noexcept
+    : heap_(alloc)
+{}
+/**
+ * Конструктор, создает вектор заданного размера
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+SmallVector<T, N, Alloc, Traits>::SmallVector(size_t size, const Alloc& alloc)
+    : heap_(size > N ? size : 0, alloc)
+    , size_(size)
+{
+    std::uninitialized_value_construct_n(Data(), size_);
+}
+/**
+ * Конструктор, создает копию передаваемого вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+SmallVector<T, N, Alloc, Traits>::SmallVector(const SmallVector& other)
+    : heap_(other.size_ > N ? other.size_ : 0,
+        AllocTraits::select_on_container_copy_construction(other.heap_.GetAllocator()))
+    , size_(other.size_)
+{
+    std::uninitialized_copy_n(other.Data(), size_, Data());
+}
+/**
+ * Конструктор перемещения. Динамическая память забирается у other целиком,
+ * элементы малого буфера перемещаются поштучно
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+SmallVector<T, N, Alloc, Traits>::SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    : heap_(other.heap_.GetAllocator())
+{
+    if (other.IsInline()) {
+        detail::MoveElements(other.Data(), other.size_, Data());
+    }
+    else {
+        heap_.Swap(other.heap_);
+    }
+    size_ = std::exchange(other.size_, 0);
+}
+
+/**
+ * Оператор копирующего присваивания
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+SmallVector<T, N, Alloc, Traits>& SmallVector<T, N, Alloc, Traits>::operator=(const SmallVector& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    // Если вместимости недостаточно - копируем элементы в новую память,
+    // и лишь затем удаляем текущие
+    if (Capacity() < other.size_) {
+        RawMemory<T, Alloc> new_heap(other.size_, heap_.GetAllocator());
+        std::uninitialized_copy_n(other.Data(), other.size_, new_heap.GetAddress());
+
+        std::destroy_n(Data(), size_);
+        heap_.Swap(new_heap);
+        size_ = other.size_;
+        return *this;
+    }
+
+    // Иначе - копируем элементы из rhs, создаем при необходимости новые
+    // или удаляем старые
+    const size_t common_size = std::min(size_, other.size_);
+    std::copy_n(other.Data(), common_size, Data());
+    if (size_ < other.size_) {
+        std::uninitialized_copy_n(other.Data() + size_, other.size_ - size_, Data() + size_);
+    }
+    else {
+        std::destroy_n(Data() + other.size_, size_ - other.size_);
+    }
+    size_ = other.size_;
+
+    return *this;
+}
+/**
+ * Оператор перемещающего присваивания
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+SmallVector<T, N, Alloc, Traits>& SmallVector<T, N, Alloc, Traits>::operator=(SmallVector&& other) noexcept(
+        std::is_nothrow_move_constructible_v<T> && AllocTraits::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+
+    std::destroy_n(Data(), size_);
+    size_ = 0;
+
+    // Динамическую память other можно забрать, если ее сможет освободить наш аллокатор
+    if (!other.IsInline() && heap_.GetAllocator() == other.heap_.GetAllocator()) {
+        heap_ = std::move(other.heap_);
+    }
+    else {
+        Reserve(other.size_);
+        detail::MoveElements(other.Data(), other.size_, Data());
+    }
+    size_ = std::exchange(other.size_, 0);
+
+    return *this;
+}
+
+/**
+ * Деструктор, вызывает деструкторы хранящихся в векторе объектов
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+SmallVector<T, N, Alloc, Traits>::~SmallVector() noexcept {
+    std::destroy_n(Data(), size_);
+}
+
+/**
+ * Изменяет размер вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+void SmallVector<T, N, Alloc, Traits>::Resize(size_t new_size) {
+    if (size_ == new_size) {
+        return;
+    }
+
+    if (size_ > new_size) {
+        std::destroy_n(Data() + new_size, size_ - new_size);
+    }
+    else {
+        Reserve(new_size);
+        std::uninitialized_value_construct_n(Data() + size_, new_size - size_);
+    }
+    size_ = new_size;
+}
+/**
+ * Резервирует память под указанное количество элементов вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+void SmallVector<T, N, Alloc, Traits>::Reserve(size_t new_capacity) {
+    if (new_capacity <= Capacity()) {
+        return;
+    }
+
+    detail::CheckCopyFallback<Traits, T>();
+    RawMemory<T, Alloc> new_heap(new_capacity, heap_.GetAllocator());
+    detail::MoveElements(Data(), size_, new_heap.GetAddress());
+    heap_.Swap(new_heap);
+}
+
+/**
+ * Передает аргументы конструктору типа T по forwarding-ссылке,
+ * полученный элемент добавляется в конец вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+template <typename... Types>
+T& SmallVector<T, N, Alloc, Traits>::EmplaceBack(Types&&... args) {
+    if (size_ < Capacity()) {
+        new(Data() + size_) T(std::forward<Types>(args)...);
+    }
+    // При нехватке места создаем элемент в новой памяти до переноса старых,
+    // так как аргументы могут ссылаться на элементы вектора
+    else {
+        detail::CheckCopyFallback<Traits, T>();
+        RawMemory<T, Alloc> new_heap(NextCapacity(size_ + 1), heap_.GetAllocator());
+
+        new(new_heap + size_) T(std::forward<Types>(args)...);
+        try {
+            detail::MoveElements(Data(), size_, new_heap.GetAddress());
+        }
+        catch (...) {
+            std::destroy_at(new_heap + size_);
+            throw;
+        }
+        heap_.Swap(new_heap);
+    }
+
+    ++size_;
+    return Data()[size_ - 1];
+}
+/**
+ * Копирует или перемещает передаваемый элемент в конец вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+template <typename ValueType>
+void SmallVector<T, N, Alloc, Traits>::PushBack(ValueType&& value) {
+    EmplaceBack(std::forward<ValueType>(value));
+}
+
+/**
+ * Копирует или перемещает передаваемый элемент в позицию pos
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+template <typename ValueType>
+typename SmallVector<T, N, Alloc, Traits>::iterator SmallVector<T, N, Alloc, Traits>::Insert(
+        const_iterator pos, ValueType&& value) {
+    return Emplace(pos, std::forward<ValueType>(value));
+}
+/**
+ * Передает аргументы конструктору типа T по forwarding-ссылке,
+ * вставляет полученный элемент в позицию pos, возвращает итератор на него
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+template <typename... Types>
+typename SmallVector<T, N, Alloc, Traits>::iterator SmallVector<T, N, Alloc, Traits>::Emplace(
+        const_iterator pos, Types&&... args) {
+    assert((0 <= pos - cbegin()) && (static_cast<size_t>(pos - cbegin()) <= size_));
+
+    const size_t index = pos - cbegin();
+    if (index == size_) {
+        EmplaceBack(std::forward<Types>(args)...);
+        return begin() + index;
+    }
+
+    // Если есть свободное место - создаем временный объект, сдвигаем хвост на один вправо
+    if (size_ < Capacity()) {
+        T temp(std::forward<Types>(args)...);
+
+        new(end()) T(std::move(Data()[size_ - 1]));
+        std::move_backward(begin() + index, end() - 1, end());
+
+        Data()[index] = std::move(temp);
+    }
+    // Иначе - создаем элемент в новой памяти и переносим остальные элементы вокруг него
+    else {
+        detail::CheckCopyFallback<Traits, T>();
+        RawMemory<T, Alloc> new_heap(NextCapacity(size_ + 1), heap_.GetAllocator());
+
+        new(new_heap + index) T(std::forward<Types>(args)...);
+        try {
+            detail::MoveElementsWithGap(Data(), size_, index, new_heap.GetAddress());
+        }
+        catch (...) {
+            std::destroy_at(new_heap + index);
+            throw;
+        }
+        heap_.Swap(new_heap);
+    }
+
+    ++size_;
+    return begin() + index;
+}
+
+/**
+ * Удаляет из вектора последний элемент
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+void SmallVector<T, N, Alloc, Traits>::PopBack() noexcept {
+    assert(size_ > 0);
+    std::destroy_at(Data() + (--size_));
+}
+/**
+ * Удаляет элемент из заданной позиции
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+typename SmallVector<T, N, Alloc, Traits>::iterator SmallVector<T, N, Alloc, Traits>::Erase(const_iterator pos) {
+    assert((0 <= pos - cbegin()) && (static_cast<size_t>(pos - cbegin()) < size_));
+
+    const size_t index = pos - cbegin();
+    std::move(begin() + (index + 1), end(), begin() + index);
+    std::destroy_at(Data() + (--size_));
+
+    return begin() + index;
+}
+
+/**
+ * Возвращает размер вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+size_t SmallVector<T, N, Alloc, Traits>::Size() const noexcept {
+    return size_;
+}
+/**
+ * Возвращает вместимость вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+size_t SmallVector<T, N, Alloc, Traits>::Capacity() const noexcept {
+    return IsInline() ? N : heap_.Capacity();
+}
+/**
+ * Проверяет, хранятся ли элементы в малом буфере
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+bool SmallVector<T, N, Alloc, Traits>::IsInline() const noexcept {
+    return heap_.Capacity() == 0;
+}
+
+/**
+ * Константная ссылка на элемент вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+const T& SmallVector<T, N, Alloc, Traits>::operator[](size_t index) const noexcept {
+    assert(index < size_);
+    return Data()[index];
+}
+/**
+ * Ссылка на элемент вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+T& SmallVector<T, N, Alloc, Traits>::operator[](size_t index) noexcept {
+    assert(index < size_);
+    return Data()[index];
+}
+
+/**
+ * Возвращает итератор на начало вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+typename SmallVector<T, N, Alloc, Traits>::iterator SmallVector<T, N, Alloc, Traits>::begin() noexcept {
+    return Data();
+}
+/**
+ * Возвращает итератор на конец вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+typename SmallVector<T, N, Alloc, Traits>::iterator SmallVector<T, N, Alloc, Traits>::end() noexcept {
+    return Data() + size_;
+}
+/**
+ * Возвращает константный итератор на начало вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+typename SmallVector<T, N, Alloc, Traits>::const_iterator SmallVector<T, N, Alloc, Traits>::begin() const noexcept {
+    return Data();
+}
+/**
+ * Возвращает константный итератор на конец вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+typename SmallVector<T, N, Alloc, Traits>::const_iterator SmallVector<T, N, Alloc, Traits>::end() const noexcept {
+    return Data() + size_;
+}
+/**
+ * Возвращает константный итератор на начало вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+typename SmallVector<T, N, Alloc, Traits>::const_iterator SmallVector<T, N, Alloc, Traits>::cbegin() const noexcept {
+    return Data();
+}
+/**
+ * Возвращает константный итератор на конец вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+typename SmallVector<T, N, Alloc, Traits>::const_iterator SmallVector<T, N, Alloc, Traits>::cend() const noexcept {
+    return Data() + size_;
+}
+
+/**
+ * Обменивает содержимое векторов. Если оба вектора используют динамическую память,
+ * обмениваются только буферы, иначе элементы малых буферов перемещаются
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+void SmallVector<T, N, Alloc, Traits>::Swap(SmallVector& other) noexcept(
+        std::is_nothrow_move_constructible_v<T> && AllocTraits::is_always_equal::value) {
+    if (!IsInline() && !other.IsInline()) {
+        heap_.Swap(other.heap_);
+        std::swap(size_, other.size_);
+        return;
+    }
+
+    SmallVector temp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(temp);
+}
+
+/**
+ * Возвращает копию аллокатора вектора
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+Alloc SmallVector<T, N, Alloc, Traits>::GetAllocator() const noexcept {
+    return heap_.GetAllocator();
+}
+
+/**
+ * Возвращает указатель на текущее хранилище элементов
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+T* SmallVector<T, N, Alloc, Traits>::Data() noexcept {
+    return IsInline() ? reinterpret_cast<T*>(storage_) : heap_.GetAddress();
+}
+template <typename T, size_t N, typename Alloc, typename Traits>
+const T* SmallVector<T, N, Alloc, Traits>::Data() const noexcept {
+    return IsInline() ? reinterpret_cast<const T*>(storage_) : heap_.GetAddress();
+}
+
+/**
+ * Возвращает вместимость, до которой следует расширить вектор,
+ * чтобы в нем поместилось required элементов
+*/
+template <typename T, size_t N, typename Alloc, typename Traits>
+size_t SmallVector<T, N, Alloc, Traits>::NextCapacity(size_t required) const noexcept {
+    return Traits::GrowthPolicy::NextCapacity(Capacity(), required, sizeof(T));
+}
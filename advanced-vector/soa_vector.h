@@ -0,0 +1,450 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Непрерывный участок одного столбца SoAVector. Используется для обработки
+ * поля всех строк одним циклом, в том числе векторизованным
+*/
+template <typename T>
+class SoAColumn {
+public:
+    SoAColumn(T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size)
+    {
+    }
+
+    T* Data() const noexcept {
+        return data_;
+    }
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    T* begin() const noexcept {
+        return data_;
+    }
+    T* end() const noexcept {
+        return data_ + size_;
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * Вектор в виде структуры массивов: каждое поле строки хранится в собственном
+ * столбце RawMemory. Циклы, обращающиеся к части полей, читают только нужные столбцы.
+ * Строка доступна как кортеж ссылок на поля, столбец - как SoAColumn
+*/
+template <typename... Fields>
+class SoAVector {
+    using Columns = std::tuple<RawMemory<Fields>...>;
+
+public:
+    static_assert(sizeof...(Fields) > 0, "SoAVector requires at least one field");
+
+    static constexpr size_t NUM_COLUMNS = sizeof...(Fields);
+
+    template <size_t I>
+    using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    // Прокси-ссылки на строку
+    using Row = std::tuple<Fields&...>;
+    using ConstRow = std::tuple<const Fields&...>;
+
+    SoAVector() = default;
+    explicit SoAVector(size_t size);
+    SoAVector(const SoAVector& other);
+    SoAVector(SoAVector&& other) noexcept;
+
+    SoAVector& operator=(const SoAVector& other);
+    SoAVector& operator=(SoAVector&& other) noexcept;
+
+    ~SoAVector() noexcept;
+
+    void Resize(size_t new_size);
+    void Reserve(size_t n);
+    void Clear() noexcept;
+
+    template <typename... Types>
+    Row EmplaceBack(Types&&... args);
+
+    void PopBack() noexcept;
+    void Erase(size_t index);
+
+    size_t Size() const noexcept;
+    size_t Capacity() const noexcept;
+
+    Row operator[](size_t index) noexcept;
+    ConstRow operator[](size_t index) const noexcept;
+
+    template <size_t I>
+    SoAColumn<FieldType<I>> Column() noexcept;
+    template <size_t I>
+    SoAColumn<const FieldType<I>> Column() const noexcept;
+
+    void Swap(SoAVector& other) noexcept;
+
+private:
+    Columns columns_;
+    size_t size_ = 0;
+
+    // Размер строки для политики роста
+    static constexpr size_t ROW_SIZE = (sizeof(Fields) + ...);
+
+    static Columns AllocateColumns(size_t capacity);
+
+    template <size_t I = 0, typename Arg, typename... Rest>
+    static void ConstructRow(Columns& columns, size_t index, Arg&& arg, Rest&&... rest);
+    template <size_t I = 0>
+    static void ValueConstructRows(Columns& columns, size_t from, size_t count);
+    template <bool ONLY_COPYING, size_t I = 0>
+    static void CopyColumns(const Columns& from, size_t size, Columns& to);
+    static void RelocateColumns(Columns& from, size_t size, Columns& to);
+    template <size_t I = 0>
+    static void FinishRelocation(Columns& from, size_t size, Columns& to) noexcept;
+    static void DestroyRows(Columns& columns, size_t from, size_t count) noexcept;
+
+    template <typename Operation>
+    static void ForEachColumn(Columns& columns, Operation&& op);
+};
+
+/**
+ * Конструктор, создает вектор из size строк с инициализированными по умолчанию полями
+*/
+template <typename... Fields>
+SoAVector<Fields...>::SoAVector(size_t size)
+    : columns_(AllocateColumns(size))
+{
+    ValueConstructRows(columns_, 0, size);
+    size_ = size;
+}
+/**
+ * Конструктор копирования
+*/
+template <typename... Fields>
+SoAVector<Fields...>::SoAVector(const SoAVector& other)
+    : columns_(AllocateColumns(other.size_))
+{
+    CopyColumns<false>(other.columns_, other.size_, columns_);
+    size_ = other.size_;
+}
+/**
+ * Конструктор перемещения
+*/
+template <typename... Fields>
+SoAVector<Fields...>::SoAVector(SoAVector&& other) noexcept {
+    Swap(other);
+}
+
+/**
+ * Оператор копирующего присваивания, обеспечивает строгую гарантию
+*/
+template <typename... Fields>
+SoAVector<Fields...>& SoAVector<Fields...>::operator=(const SoAVector& other) {
+    if (this != &other) {
+        SoAVector copy(other);
+        Swap(copy);
+    }
+    return *this;
+}
+/**
+ * Оператор перемещающего присваивания
+*/
+template <typename... Fields>
+SoAVector<Fields...>& SoAVector<Fields...>::operator=(SoAVector&& other) noexcept {
+    if (this != &other) {
+        Clear();
+        Swap(other);
+    }
+    return *this;
+}
+
+/**
+ * Деструктор, разрушает поля всех строк
+*/
+template <typename... Fields>
+SoAVector<Fields...>::~SoAVector() noexcept {
+    DestroyRows(columns_, 0, size_);
+}
+
+/**
+ * Изменяет количество строк. Новые строки инициализируются по умолчанию,
+ * при исключении вектор остается в исходном состоянии
+*/
+template <typename... Fields>
+void SoAVector<Fields...>::Resize(size_t new_size) {
+    if (new_size <= size_) {
+        DestroyRows(columns_, new_size, size_ - new_size);
+    } else {
+        Reserve(new_size);
+        ValueConstructRows(columns_, size_, new_size - size_);
+    }
+    size_ = new_size;
+}
+/**
+ * Резервирует память под n строк во всех столбцах. Если перенос строк копированием
+ * выбросит исключение, вектор остается неизменным
+*/
+template <typename... Fields>
+void SoAVector<Fields...>::Reserve(size_t n) {
+    if (n <= Capacity()) {
+        return;
+    }
+    Columns new_columns = AllocateColumns(n);
+    RelocateColumns(columns_, size_, new_columns);
+    std::swap(columns_, new_columns);
+}
+/**
+ * Удаляет все строки, сохраняя вместимость
+*/
+template <typename... Fields>
+void SoAVector<Fields...>::Clear() noexcept {
+    DestroyRows(columns_, 0, size_);
+    size_ = 0;
+}
+
+/**
+ * Добавляет строку, конструируя каждое поле из соответствующего аргумента.
+ * Обеспечивает строгую гарантию безопасности исключений
+*/
+template <typename... Fields>
+template <typename... Types>
+typename SoAVector<Fields...>::Row SoAVector<Fields...>::EmplaceBack(Types&&... args) {
+    static_assert(sizeof...(Types) == NUM_COLUMNS, "EmplaceBack requires one argument per field");
+
+    if (size_ == Capacity()) {
+        const size_t new_capacity = DefaultVectorTraits::GrowthPolicy::NextCapacity(Capacity(), size_ + 1, ROW_SIZE);
+        Columns new_columns = AllocateColumns(new_capacity);
+        // Новую строку создаем до переноса старых, так как аргументы могут ссылаться на них
+        ConstructRow(new_columns, size_, std::forward<Types>(args)...);
+        try {
+            RelocateColumns(columns_, size_, new_columns);
+        }
+        catch (...) {
+            DestroyRows(new_columns, size_, 1);
+            throw;
+        }
+        std::swap(columns_, new_columns);
+    } else {
+        ConstructRow(columns_, size_, std::forward<Types>(args)...);
+    }
+    ++size_;
+    return (*this)[size_ - 1];
+}
+
+/**
+ * Удаляет последнюю строку
+*/
+template <typename... Fields>
+void SoAVector<Fields...>::PopBack() noexcept {
+    assert(size_ > 0);
+    DestroyRows(columns_, size_ - 1, 1);
+    --size_;
+}
+/**
+ * Удаляет строку index, сдвигая последующие строки во всех столбцах
+*/
+template <typename... Fields>
+void SoAVector<Fields...>::Erase(size_t index) {
+    assert(index < size_);
+    const size_t size = size_;
+    ForEachColumn(columns_, [index, size](auto& column) {
+        auto* data = column.GetAddress();
+        std::move(data + index + 1, data + size, data + index);
+    });
+    PopBack();
+}
+
+/**
+ * Возвращает количество строк
+*/
+template <typename... Fields>
+size_t SoAVector<Fields...>::Size() const noexcept {
+    return size_;
+}
+/**
+ * Возвращает вместимость, общую для всех столбцов
+*/
+template <typename... Fields>
+size_t SoAVector<Fields...>::Capacity() const noexcept {
+    return std::get<0>(columns_).Capacity();
+}
+
+/**
+ * Возвращает кортеж ссылок на поля строки index
+*/
+template <typename... Fields>
+typename SoAVector<Fields...>::Row SoAVector<Fields...>::operator[](size_t index) noexcept {
+    assert(index < size_);
+    return std::apply([index](auto&... columns) {
+        return Row(columns[index]...);
+    }, columns_);
+}
+/**
+ * Возвращает кортеж константных ссылок на поля строки index
+*/
+template <typename... Fields>
+typename SoAVector<Fields...>::ConstRow SoAVector<Fields...>::operator[](size_t index) const noexcept {
+    assert(index < size_);
+    return std::apply([index](const auto&... columns) {
+        return ConstRow(columns[index]...);
+    }, columns_);
+}
+
+/**
+ * Возвращает столбец поля I
+*/
+template <typename... Fields>
+template <size_t I>
+SoAColumn<typename SoAVector<Fields...>::template FieldType<I>> SoAVector<Fields...>::Column() noexcept {
+    return {std::get<I>(columns_).GetAddress(), size_};
+}
+/**
+ * Возвращает константный столбец поля I
+*/
+template <typename... Fields>
+template <size_t I>
+SoAColumn<const typename SoAVector<Fields...>::template FieldType<I>> SoAVector<Fields...>::Column() const noexcept {
+    return {std::get<I>(columns_).GetAddress(), size_};
+}
+
+/**
+ * Обменивает содержимое векторов
+*/
+template <typename... Fields>
+void SoAVector<Fields...>::Swap(SoAVector& other) noexcept {
+    std::swap(columns_, other.columns_);
+    std::swap(size_, other.size_);
+}
+
+/**
+ * Выделяет столбцы вместимостью capacity. Если выделение одного из столбцов
+ * не удалось, уже выделенные освобождаются
+*/
+template <typename... Fields>
+typename SoAVector<Fields...>::Columns SoAVector<Fields...>::AllocateColumns(size_t capacity) {
+    return Columns(RawMemory<Fields>(capacity)...);
+}
+/**
+ * Конструирует поля строки index из аргументов. Если конструктор поля выбросит
+ * исключение, созданные ранее поля строки разрушаются
+*/
+template <typename... Fields>
+template <size_t I, typename Arg, typename... Rest>
+void SoAVector<Fields...>::ConstructRow(Columns& columns, size_t index, Arg&& arg, Rest&&... rest) {
+    FieldType<I>* field = std::get<I>(columns) + index;
+    new (field) FieldType<I>(std::forward<Arg>(arg));
+    if constexpr (sizeof...(Rest) > 0) {
+        try {
+            ConstructRow<I + 1>(columns, index, std::forward<Rest>(rest)...);
+        }
+        catch (...) {
+            std::destroy_at(field);
+            throw;
+        }
+    }
+}
+/**
+ * Инициализирует по умолчанию count строк начиная с from, откатывая столбцы при исключении
+*/
+template <typename... Fields>
+template <size_t I>
+void SoAVector<Fields...>::ValueConstructRows(Columns& columns, size_t from, size_t count) {
+    FieldType<I>* data = std::get<I>(columns) + from;
+    std::uninitialized_value_construct_n(data, count);
+    if constexpr (I + 1 < NUM_COLUMNS) {
+        try {
+            ValueConstructRows<I + 1>(columns, from, count);
+        }
+        catch (...) {
+            std::destroy_n(data, count);
+            throw;
+        }
+    }
+}
+/**
+ * Копирует size строк из from в to. Если ONLY_COPYING, копируются лишь столбцы,
+ * которые MoveElements переносил бы копированием. При исключении скопированные
+ * столбцы разрушаются, from не изменяется
+*/
+template <typename... Fields>
+template <bool ONLY_COPYING, size_t I>
+void SoAVector<Fields...>::CopyColumns(const Columns& from, size_t size, Columns& to) {
+    if constexpr (I < NUM_COLUMNS) {
+        if constexpr (!ONLY_COPYING || detail::MOVE_ELEMENTS_COPIES<FieldType<I>>) {
+            FieldType<I>* data = std::get<I>(to).GetAddress();
+            std::uninitialized_copy_n(std::get<I>(from).GetAddress(), size, data);
+            try {
+                CopyColumns<ONLY_COPYING, I + 1>(from, size, to);
+            }
+            catch (...) {
+                std::destroy_n(data, size);
+                throw;
+            }
+        }
+        else {
+            CopyColumns<ONLY_COPYING, I + 1>(from, size, to);
+        }
+    }
+}
+/**
+ * Переносит size строк из from в to. Сначала копируются столбцы, чьи элементы
+ * нельзя безопасно переместить, и только после их успеха перемещаются остальные,
+ * поэтому при исключении from остается неизменным
+*/
+template <typename... Fields>
+void SoAVector<Fields...>::RelocateColumns(Columns& from, size_t size, Columns& to) {
+    CopyColumns<true>(from, size, to);
+    FinishRelocation(from, size, to);
+}
+/**
+ * Вторая стадия RelocateColumns: разрушает исходные элементы скопированных столбцов
+ * и перемещает остальные
+*/
+template <typename... Fields>
+template <size_t I>
+void SoAVector<Fields...>::FinishRelocation(Columns& from, size_t size, Columns& to) noexcept {
+    if constexpr (I < NUM_COLUMNS) {
+        if constexpr (detail::MOVE_ELEMENTS_COPIES<FieldType<I>>) {
+            std::destroy_n(std::get<I>(from).GetAddress(), size);
+        }
+        else {
+            detail::MoveElements(std::get<I>(from).GetAddress(), size, std::get<I>(to).GetAddress());
+        }
+        FinishRelocation<I + 1>(from, size, to);
+    }
+}
+/**
+ * Разрушает поля count строк начиная с from во всех столбцах
+*/
+template <typename... Fields>
+void SoAVector<Fields...>::DestroyRows(Columns& columns, size_t from, size_t count) noexcept {
+    ForEachColumn(columns, [from, count](auto& column) {
+        std::destroy_n(column.GetAddress() + from, count);
+    });
+}
+/**
+ * Вызывает op для каждого столбца
+*/
+template <typename... Fields>
+template <typename Operation>
+void SoAVector<Fields...>::ForEachColumn(Columns& columns, Operation&& op) {
+    std::apply([&op](auto&... column) {
+        (op(column), ...);
+    }, columns);
+}
@@ -0,0 +1,557 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Политика переполнения StaticVector, проверяющая вместимость только через assert.
+ * В сборке с NDEBUG проверка исчезает, и добавление в заполненный вектор - ошибка вызывающего
+*/
+struct AssertOverflow {
+    static void OnOverflow() noexcept {
+        assert(!"StaticVector capacity exceeded");
+    }
+};
+
+/**
+ * Политика переполнения StaticVector, выбрасывающая std::length_error
+*/
+struct ThrowOverflow {
+    [[noreturn]] static void OnOverflow() {
+        throw std::length_error("StaticVector capacity exceeded");
+    }
+};
+
+namespace detail {
+
+/**
+ * Наименьший беззнаковый тип, вмещающий размеры от 0 до N
+*/
+template <size_t N>
+using StaticSizeType = std::conditional_t<N <= UINT8_MAX, uint8_t,
+    std::conditional_t<N <= UINT16_MAX, uint16_t,
+    std::conditional_t<N <= UINT32_MAX, uint32_t, size_t>>>;
+
+/**
+ * Признак хранения элементов StaticVector массивом T[N]: для таких типов операции вектора
+ * сводятся к присваиваниям и доступны в константных выражениях
+*/
+template <typename T>
+inline constexpr bool STATIC_STORAGE_TRIVIAL = std::is_trivial_v<T> && std::is_copy_assignable_v<T>;
+
+template <typename T, size_t N, bool Trivial = STATIC_STORAGE_TRIVIAL<T>>
+struct StaticStorage;
+
+/**
+ * Хранилище тривиальных элементов. По умолчанию массив обнуляется, как того требует
+ * constexpr-конструктор; конструктор с DEFAULT_INIT оставляет его неинициализированным.
+ * Копирование и разрушение тривиальны, поэтому сам вектор остается тривиально копируемым
+*/
+template <typename T, size_t N>
+struct StaticStorage<T, N, true> {
+    constexpr StaticStorage() noexcept
+        : values{}
+    {}
+    explicit StaticStorage(DefaultInitT) noexcept {
+    }
+
+    constexpr T* Data() noexcept {
+        return values;
+    }
+    constexpr const T* Data() const noexcept {
+        return values;
+    }
+
+    T values[N == 0 ? 1 : N];
+    StaticSizeType<N> size = 0;
+};
+
+/**
+ * Хранилище нетривиальных элементов в неинициализированном буфере
+*/
+template <typename T, size_t N>
+struct StaticStorage<T, N, false> {
+    StaticStorage() noexcept {
+    }
+    explicit StaticStorage(DefaultInitT) noexcept {
+    }
+
+    StaticStorage(const StaticStorage& other) {
+        const T* from = other.Data();
+        T* to = Data();
+        ConstructChunks<SequentialExecution>(to, other.size, [from, to](size_t offset, size_t n) {
+            std::uninitialized_copy_n(from + offset, n, to + offset);
+        });
+        size = other.size;
+    }
+    // Элементы переносятся так же, как при переаллокации Vector, other остается пустым
+    StaticStorage(StaticStorage&& other) noexcept(!MOVE_ELEMENTS_COPIES<T>
+            && (IsTriviallyRelocatable_v<T> || std::is_nothrow_move_constructible_v<T>)) {
+        MoveElements(other.Data(), other.size, Data());
+        size = std::exchange(other.size, 0);
+    }
+
+    StaticStorage& operator=(const StaticStorage& other) {
+        if (this == &other) {
+            return *this;
+        }
+        // Присваиваем общую часть, затем создаем недостающие или удаляем лишние элементы
+        const size_t common_size = std::min(size, other.size);
+        std::copy_n(other.Data(), common_size, Data());
+        if (size < other.size) {
+            std::uninitialized_copy_n(other.Data() + size, other.size - size, Data() + size);
+        }
+        else {
+            std::destroy_n(Data() + other.size, size - other.size);
+        }
+        size = other.size;
+        return *this;
+    }
+    StaticStorage& operator=(StaticStorage&& other) noexcept(!MOVE_ELEMENTS_COPIES<T>
+            && (IsTriviallyRelocatable_v<T> || std::is_nothrow_move_constructible_v<T>)) {
+        if (this == &other) {
+            return *this;
+        }
+        DestroyChunks<SequentialExecution>(Data(), size);
+        size = 0;
+        MoveElements(other.Data(), other.size, Data());
+        size = std::exchange(other.size, 0);
+        return *this;
+    }
+
+    ~StaticStorage() noexcept {
+        DestroyChunks<SequentialExecution>(Data(), size);
+    }
+
+    T* Data() noexcept {
+        return reinterpret_cast<T*>(bytes);
+    }
+    const T* Data() const noexcept {
+        return reinterpret_cast<const T*>(bytes);
+    }
+
+    alignas(T) unsigned char bytes[(N == 0 ? 1 : N) * sizeof(T)];
+    StaticSizeType<N> size = 0;
+};
+
+} // namespace detail
+
+/**
+ * Вектор фиксированной вместимости N с элементами внутри объекта: не обращается к куче
+ * и не проверяет вместимость на каждой операции сверх политики OverflowPolicy
+ * (AssertOverflow либо ThrowOverflow). TryEmplaceBack сообщает о переполнении
+ * возвращаемым значением независимо от политики.
+ *
+ * Для тривиальных T вектор хранит массив T[N], тривиально копируется
+ * и его операции, кроме конструирования с DEFAULT_INIT, доступны в constexpr-функциях.
+ * Для остальных типов используются те же функции конструирования и переноса элементов,
+ * что и в Vector, поэтому гарантии исключений совпадают
+*/
+template <typename T, size_t N, typename OverflowPolicy = AssertOverflow>
+class StaticVector {
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t CAPACITY = N;
+
+    StaticVector() = default;
+    explicit StaticVector(DefaultInitT);
+    constexpr explicit StaticVector(size_t size);
+    template <size_t M>
+    constexpr StaticVector(const T (&values)[M]);
+
+    constexpr void Resize(size_t new_size);
+    constexpr void Clear() noexcept;
+
+    template <typename... Types>
+    constexpr T& EmplaceBack(Types&&... args);
+    template <typename ValueType>
+    constexpr void PushBack(ValueType&& value);
+    template <typename... Types>
+    constexpr bool TryEmplaceBack(Types&&... args);
+    template <typename ValueType>
+    constexpr bool TryPushBack(ValueType&& value);
+
+    template <typename... Types>
+    constexpr iterator Emplace(const_iterator pos, Types&&... args);
+    template <typename ValueType>
+    constexpr iterator Insert(const_iterator pos, ValueType&& value);
+
+    constexpr void PopBack() noexcept;
+    constexpr iterator Erase(const_iterator pos);
+
+    constexpr size_t Size() const noexcept;
+    static constexpr size_t Capacity() noexcept;
+    constexpr bool IsFull() const noexcept;
+
+    constexpr const T& operator[](size_t index) const noexcept;
+    constexpr T& operator[](size_t index) noexcept;
+
+    constexpr iterator begin() noexcept;
+    constexpr iterator end() noexcept;
+    constexpr const_iterator begin() const noexcept;
+    constexpr const_iterator end() const noexcept;
+    constexpr const_iterator cbegin() const noexcept;
+    constexpr const_iterator cend() const noexcept;
+
+    constexpr T* Data() noexcept;
+    constexpr const T* Data() const noexcept;
+
+    constexpr void Swap(StaticVector& other);
+
+private:
+    static constexpr bool TRIVIAL = detail::STATIC_STORAGE_TRIVIAL<T>;
+
+    detail::StaticStorage<T, N> storage_;
+
+    static constexpr void CheckCapacity(size_t required);
+};
+
+template <typename T, size_t N, typename OverflowPolicy>
+struct IsTriviallyRelocatable<StaticVector<T, N, OverflowPolicy>> : IsTriviallyRelocatable<T> {};
+
+/**
+ * Конструктор пустого вектора, не инициализирующий буфер тривиальных элементов
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+StaticVector<T, N, OverflowPolicy>::StaticVector(DefaultInitT)
+    : storage_(DEFAULT_INIT)
+{}
+/**
+ * Конструктор, создает вектор заданного размера
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr StaticVector<T, N, OverflowPolicy>::StaticVector(size_t size)
+    : storage_()
+{
+    Resize(size);
+}
+/**
+ * Конструктор, копирует элементы массива values. Вместимость проверяется при компиляции
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+template <size_t M>
+constexpr StaticVector<T, N, OverflowPolicy>::StaticVector(const T (&values)[M])
+    : storage_()
+{
+    static_assert(M <= N, "StaticVector capacity is less than the number of values");
+    for (size_t i = 0; i < M; ++i) {
+        EmplaceBack(values[i]);
+    }
+}
+
+/**
+ * Изменяет размер вектора, новые элементы инициализируются значением по умолчанию
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr void StaticVector<T, N, OverflowPolicy>::Resize(size_t new_size) {
+    CheckCapacity(new_size);
+    const size_t size = storage_.size;
+    if constexpr (TRIVIAL) {
+        for (size_t i = size; i < new_size; ++i) {
+            storage_.Data()[i] = T();
+        }
+    }
+    else {
+        if (size > new_size) {
+            std::destroy_n(Data() + new_size, size - new_size);
+        }
+        else {
+            std::uninitialized_value_construct_n(Data() + size, new_size - size);
+        }
+    }
+    storage_.size = static_cast<detail::StaticSizeType<N>>(new_size);
+}
+/**
+ * Удаляет все элементы вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr void StaticVector<T, N, OverflowPolicy>::Clear() noexcept {
+    if constexpr (!TRIVIAL) {
+        detail::DestroyChunks<SequentialExecution>(Data(), storage_.size);
+    }
+    storage_.size = 0;
+}
+
+/**
+ * Передает аргументы конструктору типа T по forwarding-ссылке,
+ * полученный элемент добавляется в конец вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+template <typename... Types>
+constexpr T& StaticVector<T, N, OverflowPolicy>::EmplaceBack(Types&&... args) {
+    CheckCapacity(storage_.size + size_t{1});
+    T* slot = storage_.Data() + storage_.size;
+    if constexpr (TRIVIAL) {
+        *slot = T(std::forward<Types>(args)...);
+    }
+    else {
+        new (slot) T(std::forward<Types>(args)...);
+    }
+    ++storage_.size;
+    return *slot;
+}
+/**
+ * Копирует или перемещает передаваемый элемент в конец вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+template <typename ValueType>
+constexpr void StaticVector<T, N, OverflowPolicy>::PushBack(ValueType&& value) {
+    EmplaceBack(std::forward<ValueType>(value));
+}
+/**
+ * Добавляет элемент в конец вектора, если в нем есть место. Возвращает false,
+ * не вызывая политику переполнения и не конструируя элемент, если вектор заполнен
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+template <typename... Types>
+constexpr bool StaticVector<T, N, OverflowPolicy>::TryEmplaceBack(Types&&... args) {
+    if (IsFull()) {
+        return false;
+    }
+    EmplaceBack(std::forward<Types>(args)...);
+    return true;
+}
+/**
+ * Копирует или перемещает передаваемый элемент в конец вектора, если в нем есть место
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+template <typename ValueType>
+constexpr bool StaticVector<T, N, OverflowPolicy>::TryPushBack(ValueType&& value) {
+    return TryEmplaceBack(std::forward<ValueType>(value));
+}
+
+/**
+ * Передает аргументы конструктору типа T по forwarding-ссылке,
+ * вставляет полученный элемент в позицию pos, возвращает итератор на него
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+template <typename... Types>
+constexpr typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::Emplace(
+        const_iterator pos, Types&&... args) {
+    assert(cbegin() <= pos && pos <= cend());
+
+    const size_t index = pos - cbegin();
+    const size_t size = storage_.size;
+    if (index == size) {
+        return std::addressof(EmplaceBack(std::forward<Types>(args)...));
+    }
+    CheckCapacity(size + 1);
+
+    T* data = storage_.Data();
+    // Значение создается до сдвига, так как аргументы могут ссылаться на элементы вектора
+    if constexpr (TRIVIAL) {
+        T temp(std::forward<Types>(args)...);
+        for (size_t i = size; i > index; --i) {
+            data[i] = data[i - 1];
+        }
+        data[index] = temp;
+    }
+    else if constexpr (IsTriviallyRelocatable_v<T>) {
+        alignas(T) unsigned char buffer[sizeof(T)];
+        new (buffer) T(std::forward<Types>(args)...);
+        std::memmove(static_cast<void*>(data + (index + 1)), static_cast<const void*>(data + index),
+            (size - index) * sizeof(T));
+        std::memcpy(static_cast<void*>(data + index), static_cast<const void*>(buffer), sizeof(T));
+    }
+    else {
+        T temp(std::forward<Types>(args)...);
+        new (data + size) T(std::move(data[size - 1]));
+        std::move_backward(data + index, data + (size - 1), data + size);
+        data[index] = std::move(temp);
+    }
+
+    ++storage_.size;
+    return data + index;
+}
+/**
+ * Копирует или перемещает передаваемый элемент в позицию pos
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+template <typename ValueType>
+constexpr typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::Insert(
+        const_iterator pos, ValueType&& value) {
+    return Emplace(pos, std::forward<ValueType>(value));
+}
+
+/**
+ * Удаляет из вектора последний элемент
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr void StaticVector<T, N, OverflowPolicy>::PopBack() noexcept {
+    assert(storage_.size > 0);
+    --storage_.size;
+    if constexpr (!TRIVIAL) {
+        std::destroy_at(Data() + storage_.size);
+    }
+}
+/**
+ * Удаляет элемент из заданной позиции
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::Erase(
+        const_iterator pos) {
+    assert(cbegin() <= pos && pos < cend());
+
+    const size_t index = pos - cbegin();
+    T* data = storage_.Data();
+    if constexpr (TRIVIAL) {
+        for (size_t i = index + 1; i < storage_.size; ++i) {
+            data[i - 1] = data[i];
+        }
+        --storage_.size;
+    }
+    else {
+        std::move(data + (index + 1), data + storage_.size, data + index);
+        PopBack();
+    }
+    return data + index;
+}
+
+/**
+ * Возвращает размер вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr size_t StaticVector<T, N, OverflowPolicy>::Size() const noexcept {
+    return storage_.size;
+}
+/**
+ * Возвращает вместимость вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr size_t StaticVector<T, N, OverflowPolicy>::Capacity() noexcept {
+    return N;
+}
+/**
+ * Проверяет, что вектор заполнен до вместимости
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr bool StaticVector<T, N, OverflowPolicy>::IsFull() const noexcept {
+    return storage_.size == N;
+}
+
+/**
+ * Константная ссылка на элемент вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr const T& StaticVector<T, N, OverflowPolicy>::operator[](size_t index) const noexcept {
+    assert(index < storage_.size);
+    return storage_.Data()[index];
+}
+/**
+ * Ссылка на элемент вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr T& StaticVector<T, N, OverflowPolicy>::operator[](size_t index) noexcept {
+    assert(index < storage_.size);
+    return storage_.Data()[index];
+}
+
+/**
+ * Возвращает итератор на начало вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::begin() noexcept {
+    return storage_.Data();
+}
+/**
+ * Возвращает итератор на конец вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::end() noexcept {
+    return storage_.Data() + storage_.size;
+}
+/**
+ * Возвращает константный итератор на начало вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr typename StaticVector<T, N, OverflowPolicy>::const_iterator
+StaticVector<T, N, OverflowPolicy>::begin() const noexcept {
+    return storage_.Data();
+}
+/**
+ * Возвращает константный итератор на конец вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr typename StaticVector<T, N, OverflowPolicy>::const_iterator
+StaticVector<T, N, OverflowPolicy>::end() const noexcept {
+    return storage_.Data() + storage_.size;
+}
+/**
+ * Возвращает константный итератор на начало вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr typename StaticVector<T, N, OverflowPolicy>::const_iterator
+StaticVector<T, N, OverflowPolicy>::cbegin() const noexcept {
+    return begin();
+}
+/**
+ * Возвращает константный итератор на конец вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr typename StaticVector<T, N, OverflowPolicy>::const_iterator
+StaticVector<T, N, OverflowPolicy>::cend() const noexcept {
+    return end();
+}
+
+/**
+ * Возвращает указатель на первый элемент вектора
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr T* StaticVector<T, N, OverflowPolicy>::Data() noexcept {
+    return storage_.Data();
+}
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr const T* StaticVector<T, N, OverflowPolicy>::Data() const noexcept {
+    return storage_.Data();
+}
+
+/**
+ * Обменивает содержимое векторов: общая часть обменивается поэлементно,
+ * остаток большего вектора переносится в меньший
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr void StaticVector<T, N, OverflowPolicy>::Swap(StaticVector& other) {
+    StaticVector* longer = storage_.size >= other.storage_.size ? this : &other;
+    StaticVector* shorter = longer == this ? &other : this;
+    const size_t common_size = shorter->storage_.size;
+    const size_t rest = longer->storage_.size - common_size;
+
+    T* from = longer->storage_.Data();
+    T* to = shorter->storage_.Data();
+    if constexpr (TRIVIAL) {
+        for (size_t i = 0; i < common_size; ++i) {
+            T temp = from[i];
+            from[i] = to[i];
+            to[i] = temp;
+        }
+        for (size_t i = common_size; i < common_size + rest; ++i) {
+            to[i] = from[i];
+        }
+    }
+    else {
+        std::swap_ranges(from, from + common_size, to);
+        detail::MoveElements(from + common_size, rest, to + common_size);
+    }
+    // std::swap не является constexpr в C++17
+    const auto size = longer->storage_.size;
+    longer->storage_.size = shorter->storage_.size;
+    shorter->storage_.size = size;
+}
+
+/**
+ * Вызывает политику переполнения, если required элементов не помещаются в вектор
+*/
+template <typename T, size_t N, typename OverflowPolicy>
+constexpr void StaticVector<T, N, OverflowPolicy>::CheckCapacity(size_t required) {
+    if (required > N) {
+        OverflowPolicy::OnOverflow();
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// Тип с подсчетом операций над объектами, используемый тестами и бенчмарками
+struct Obj {
+    Obj() {
+        if (default_construction_throw_countdown > 0) {
+            if (--default_construction_throw_countdown == 0) {
+                throw std::runtime_error("Oops");
+            }
+        }
+        ++num_default_constructed;
+    }
+
+    explicit Obj(int id)
+        : id(id)  //
+    {
+        ++num_constructed_with_id;
+    }
+
+    Obj(int id, std::string name)
+        : id(id)
+        , name(std::move(name))  //
+    {
+        ++num_constructed_with_id_and_name;
+    }
+
+    Obj(const Obj& other)
+        : id(other.id)  //
+    {
+        if (other.throw_on_copy) {
+            throw std::runtime_error("Oops");
+        }
+        ++num_copied;
+    }
+
+    Obj(Obj&& other) noexcept
+        : id(other.id)  //
+    {
+        ++num_moved;
+    }
+
+    Obj& operator=(const Obj& other) {
+        if (this != &other) {
+            id = other.id;
+            name = other.name;
+            ++num_assigned;
+        }
+        return *this;
+    }
+
+    Obj& operator=(Obj&& other) noexcept {
+        id = other.id;
+        name = std::move(other.name);
+        ++num_move_assigned;
+        return *this;
+    }
+
+    ~Obj() {
+        ++num_destroyed;
+        id = 0;
+    }
+
+    static int GetAliveObjectCount() {
+        return num_default_constructed + num_copied + num_moved + num_constructed_with_id
+            + num_constructed_with_id_and_name - num_destroyed;
+    }
+
+    static void ResetCounters() {
+        default_construction_throw_countdown = 0;
+        num_default_constructed = 0;
+        num_copied = 0;
+        num_moved = 0;
+        num_destroyed = 0;
+        num_constructed_with_id = 0;
+        num_constructed_with_id_and_name = 0;
+        num_assigned = 0;
+        num_move_assigned = 0;
+    }
+
+    bool throw_on_copy = false;
+    int id = 0;
+    std::string name;
+
+    static inline int default_construction_throw_countdown = 0;
+    static inline int num_default_constructed = 0;
+    static inline int num_constructed_with_id = 0;
+    static inline int num_constructed_with_id_and_name = 0;
+    static inline int num_copied = 0;
+    static inline int num_moved = 0;
+    static inline int num_destroyed = 0;
+    static inline int num_assigned = 0;
+    static inline int num_move_assigned = 0;
+};
+
+// Счетчики аллокаций, выполненных CountingAllocator
+struct AllocationStats {
+    static void Reset() {
+        num_allocations = 0;
+        allocated_bytes = 0;
+        live_bytes = 0;
+        peak_bytes = 0;
+    }
+
+    inline static size_t num_allocations = 0;
+    inline static size_t allocated_bytes = 0;
+    inline static size_t live_bytes = 0;
+    inline static size_t peak_bytes = 0;
+};
+
+// Аллокатор, собирающий статистику в AllocationStats
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        ++AllocationStats::num_allocations;
+        AllocationStats::allocated_bytes += n * sizeof(T);
+        AllocationStats::live_bytes += n * sizeof(T);
+        AllocationStats::peak_bytes = std::max(AllocationStats::peak_bytes, AllocationStats::live_bytes);
+        return std::allocator<T>{}.allocate(n);
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        AllocationStats::live_bytes -= n * sizeof(T);
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    bool operator==(const CountingAllocator& /*other*/) const noexcept {
+        return true;
+    }
+    bool operator!=(const CountingAllocator& /*other*/) const noexcept {
+        return false;
+    }
+};
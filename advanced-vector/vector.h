@@ -1,33 +1,694 @@
 #pragma once
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <limits>
 #include <new>
 #include <memory>
+#include <memory_resource>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
 
+/**
+ * Признак тривиальной перемещаемости типа: объект можно перенести на новое место
+ * побайтовым копированием, не вызывая конструктор перемещения и деструктор
+ * исходного объекта. Автоматически выводится для тривиально копируемых типов,
+ * для пользовательских типов включается явной специализацией:
+ *
+ *     template <>
+ *     struct IsTriviallyRelocatable<MyType> : std::true_type {};
+*/
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool IsTriviallyRelocatable_v = IsTriviallyRelocatable<T>::value;
+
+/**
+ * Аллокатор на основе malloc/realloc. Помимо стандартного интерфейса реализует
+ * reallocate, позволяющий расширять буфер тривиально перемещаемых объектов без
+ * копирования: realloc пытается увеличить блок на месте, а для крупных блоков
+ * glibc выполняет переотображение страниц через mremap
+*/
+template <typename T>
+struct MallocAllocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), 
+        "MallocAllocator does not support over-aligned types");
+
+    MallocAllocator() = default;
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* buf = std::malloc(n * sizeof(T));
+        if (buf == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(buf);
+    }
+    void deallocate(T* buf, size_t /*n*/) noexcept {
+        std::free(buf);
+    }
+    /**
+     * Изменяет размер блока buf, сохраняя его содержимое побайтово. Блок может 
+     * переместиться. При ошибке выбрасывает std::bad_alloc, исходный блок остается валидным
+    */
+    T* reallocate(T* buf, size_t /*old_n*/, size_t new_n) {
+        if (new_n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* new_buf = std::realloc(static_cast<void*>(buf), new_n * sizeof(T));
+        if (new_buf == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(new_buf);
+    }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const MallocAllocator<U>& /*other*/) const noexcept {
+        return false;
+    }
+};
+
+/**
+ * Аллокатор, выравнивающий буфер по границе Alignment байт (кеш-линия, регистр SIMD)
+ * при помощи выровненных operator new/operator delete
+*/
+template <typename T, size_t Alignment = std::max(alignof(T), size_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__})>
+struct AlignedAllocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not be weaker than alignof(T)");
+
+    static constexpr size_t ALIGNMENT = Alignment;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, std::max(Alignment, alignof(U))>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U, size_t OtherAlignment>
+    AlignedAllocator(const AlignedAllocator<U, OtherAlignment>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+    void deallocate(T* buf, size_t /*n*/) noexcept {
+        operator delete(buf, std::align_val_t{Alignment});
+    }
+
+    template <typename U, size_t OtherAlignment>
+    bool operator==(const AlignedAllocator<U, OtherAlignment>& /*other*/) const noexcept {
+        return Alignment == OtherAlignment;
+    }
+    template <typename U, size_t OtherAlignment>
+    bool operator!=(const AlignedAllocator<U, OtherAlignment>& other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+/**
+ * Гарантированное аллокатором выравнивание буфера. Аллокатор может объявить 
+ * его статической константой ALIGNMENT, иначе гарантируется лишь alignof(T)
+*/
+template <typename Alloc, typename = void>
+struct AllocatorAlignment
+    : std::integral_constant<size_t, alignof(typename std::allocator_traits<Alloc>::value_type)> {};
+
+template <typename Alloc>
+struct AllocatorAlignment<Alloc, std::void_t<decltype(Alloc::ALIGNMENT)>>
+    : std::integral_constant<size_t, Alloc::ALIGNMENT> {};
+
 template <typename T>
+struct AllocatorAlignment<std::allocator<T>>
+    : std::integral_constant<size_t, std::max(alignof(T), size_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__})> {};
+
+template <typename Alloc>
+inline constexpr size_t AllocatorAlignment_v = AllocatorAlignment<Alloc>::value;
+
+/**
+ * Признак наличия у аллокатора метода reallocate(buf, old_n, new_n), 
+ * изменяющего размер блока с побайтовым сохранением содержимого
+*/
+template <typename Alloc, typename = void>
+struct HasReallocate : std::false_type {};
+
+template <typename Alloc>
+struct HasReallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+    std::declval<typename std::allocator_traits<Alloc>::pointer>(), size_t{}, size_t{}))>>
+    : std::true_type {};
+
+template <typename Alloc>
+inline constexpr bool HasReallocate_v = HasReallocate<Alloc>::value;
+
+/**
+ * Политика геометрического роста вместимости: при нехватке места вместимость
+ * умножается на Numerator / Denominator, но не становится меньше MinCapacity
+ * и требуемого количества элементов
+*/
+template <size_t Numerator, size_t Denominator = 1, size_t MinCapacity = 1>
+struct GeometricGrowth {
+    static_assert(Denominator != 0 && Numerator > Denominator, "Growth factor must be greater than 1");
+
+    static size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        const size_t grown = capacity > std::numeric_limits<size_t>::max() / Numerator
+            ? std::numeric_limits<size_t>::max()
+            : capacity * Numerator / Denominator;
+        return std::max({grown, required, MinCapacity});
+    }
+};
+
+using DoublingGrowth = GeometricGrowth<2>;
+using GoldenGrowth = GeometricGrowth<3, 2>;
+
+/**
+ * Политика-адаптер, округляющая размер буфера, вычисленный политикой Base, 
+ * вверх до кратного Granularity байт (размер класса аллокатора, страница памяти)
+*/
+template <typename Base, size_t Granularity>
+struct RoundedGrowth {
+    static_assert(Granularity != 0, "Granularity must be positive");
+
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t base = Base::NextCapacity(capacity, required, element_size);
+        if (base > (std::numeric_limits<size_t>::max() - Granularity) / element_size) {
+            return base;
+        }
+        const size_t bytes = (base * element_size + Granularity - 1) / Granularity * Granularity;
+        return bytes / element_size;
+    }
+};
+
+template <typename Base>
+using PageRoundedGrowth = RoundedGrowth<Base, 4096>;
+
+/**
+ * Политика освобождения памяти, при которой вектор никогда не уменьшает вместимость сам
+*/
+struct NoShrink {
+    static size_t ShrunkCapacity(size_t /*size*/, size_t capacity) noexcept {
+        return capacity;
+    }
+};
+
+/**
+ * Политика освобождения памяти с гистерезисом: вместимость уменьшается, когда размер
+ * становится меньше 1/Divisor вместимости, до удвоенного размера (но не ниже MinCapacity).
+ * Запас между порогами роста и уменьшения исключает переаллокации при колебаниях размера
+*/
+template <size_t Divisor = 4, size_t MinCapacity = 16>
+struct HysteresisShrink {
+    static_assert(Divisor > 2, "Shrink threshold must leave room for growth");
+
+    static size_t ShrunkCapacity(size_t size, size_t capacity) noexcept {
+        if (capacity <= MinCapacity || size >= capacity / Divisor) {
+            return capacity;
+        }
+        return std::max(size * 2, MinCapacity);
+    }
+};
+
+/**
+ * Политика сбора статистики, не собирающая ничего. Политика статистики является
+ * базовым классом вектора, поэтому пустая политика не увеличивает его размер.
+ * Политики со сбором статистики объявлены в vector_stats.h
+*/
+struct NoStats {
+    // Вызывается при выделении буфера вместимостью new_capacity взамен буфера old_capacity
+    void OnAllocate(size_t /*old_capacity*/, size_t /*new_capacity*/, size_t /*bytes*/) noexcept {
+    }
+    // Вызывается при переносе count элементов в новый буфер копированием или перемещением
+    void OnRelocate(size_t /*count*/, bool /*copied*/) noexcept {
+    }
+};
+
+/**
+ * Политика выполнения массовых операций над элементами в вызывающем потоке.
+ * Политика разбивает диапазон из count элементов на ChunkCount(count) частей и
+ * выполняет task(i) для каждой из них; задачи не выбрасывают исключений.
+ * Параллельная политика объявлена в parallel_execution.h
+*/
+struct SequentialExecution {
+    static constexpr size_t ChunkCount(size_t /*count*/) noexcept {
+        return 1;
+    }
+    template <typename Task>
+    static void Run(size_t chunks, Task& task) noexcept {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            task(chunk);
+        }
+    }
+};
+
+/**
+ * Политики проверки предусловий на границе API вектора: индекса в operator[], позиции
+ * в Emplace и Erase, непустоты в PopBack, результата ResizeAndOverwrite, выравнивания
+ * в AssumeAligned, а также смещений и индексов в RawMemory вектора. Политика вызывает
+ * Check(condition, message); NOTHROW сообщает, может ли проверка выбросить исключение.
+ * Внутренние циклы, которым проверки не нужны ни в одной сборке, обращаются
+ * к элементам через UncheckedAt
+*/
+
+// Проверки отключены во всех сборках
+struct NoChecks {
+    static constexpr bool NOTHROW = true;
+
+    static void Check(bool /*condition*/, const char* /*message*/) noexcept {
+    }
+};
+
+// Проверки выполняются assert и отключаются вместе с ним макросом NDEBUG
+struct AssertChecks {
+    static constexpr bool NOTHROW = true;
+
+    static void Check([[maybe_unused]] bool condition, [[maybe_unused]] const char* message) noexcept {
+        assert(condition && message);
+    }
+};
+
+// Нарушение предусловия выбрасывает std::out_of_range в любой сборке
+struct ThrowChecks {
+    static constexpr bool NOTHROW = false;
+
+    static void Check(bool condition, const char* message) {
+        if (!condition) {
+            throw std::out_of_range(message);
+        }
+    }
+};
+
+// Нарушение предусловия выводится в stderr, выполнение продолжается
+struct LogChecks {
+    static constexpr bool NOTHROW = true;
+
+    static void Check(bool condition, const char* message) noexcept {
+        if (!condition) {
+            std::fprintf(stderr, "Vector precondition violated: %s\n", message);
+        }
+    }
+};
+
+/**
+ * Политики реакции на перенос копированием: при переаллокации элементы копируются,
+ * если конструктор перемещения T не noexcept, а копирование доступно. Вектор вызывает
+ * OnCopyFallback<T>() только для таких типов, поэтому политика срабатывает на этапе
+ * компиляции при инстанцировании переносящих операций
+*/
+
+// Перенос копированием допускается молча
+struct AllowCopyFallback {
+    template <typename T>
+    static void OnCopyFallback() noexcept {
+    }
+};
+
+// Перенос копированием допускается, компилятор выводит предупреждение с типом T
+struct WarnCopyFallback {
+    template <typename T>
+    [[deprecated("T's move constructor is not noexcept: the container copies elements on reallocation")]]
+    static void OnCopyFallback() noexcept {
+    }
+};
+
+// Перенос копированием запрещен: ошибка компиляции
+struct ForbidCopyFallback {
+    template <typename T>
+    static void OnCopyFallback() noexcept {
+        static_assert(sizeof(T) == 0,
+            "T's move constructor is not noexcept: the container would copy elements on reallocation");
+    }
+};
+
+/**
+ * Набор политик вектора по умолчанию. Для настройки поведения вектора объявите
+ * наследника и переопределите нужные политики:
+ *
+ *     struct MyTraits : DefaultVectorTraits {
+ *         using GrowthPolicy = GoldenGrowth;
+ *     };
+ *     Vector<int, std::allocator<int>, MyTraits> v;
+*/
+struct DefaultVectorTraits {
+    using GrowthPolicy = DoublingGrowth;
+    using ShrinkPolicy = NoShrink;
+    using StatsPolicy = NoStats;
+    using ExecutionPolicy = SequentialExecution;
+    using CheckPolicy = AssertChecks;
+    using CopyFallbackPolicy = AllowCopyFallback;
+};
+
+/**
+ * Тег конструирования элементов инициализацией по умолчанию: для тривиальных типов
+ * память остается неинициализированной, что избавляет от обнуления буфера,
+ * который будет немедленно перезаписан
+*/
+struct DefaultInitT {
+    explicit DefaultInitT() = default;
+};
+
+inline constexpr DefaultInitT DEFAULT_INIT{};
+
+/**
+ * Неинициализированный хвост буфера вектора, выданный GetWriteBuffer:
+ * size ячеек, начиная с data, в которые производитель записывает элементы
+*/
+template <typename T>
+struct WriteBuffer {
+    T* data = nullptr;
+    size_t size = 0;
+
+    T* begin() const noexcept {
+        return data;
+    }
+    T* end() const noexcept {
+        return data + size;
+    }
+};
+
+template <typename T, typename Alloc = std::allocator<T>, typename CheckPolicy = AssertChecks>
 class RawMemory;
 
+namespace detail {
+
+/**
+ * Признак того, что MoveElements копирует элементы вместо перемещения: 
+ * конструктор перемещения может выбросить исключение, а копирование доступно
+*/
 template <typename T>
-class Vector {
+inline constexpr bool MOVE_ELEMENTS_COPIES = !IsTriviallyRelocatable_v<T> 
+    && !std::is_nothrow_move_constructible_v<T> && std::is_copy_constructible_v<T>;
+
+/**
+ * Вызывает политику Traits::CopyFallbackPolicy, если перенос элементов T выполняется копированием
+*/
+template <typename Traits, typename T>
+void CheckCopyFallback() noexcept {
+    if constexpr (MOVE_ELEMENTS_COPIES<T>) {
+        Traits::CopyFallbackPolicy::template OnCopyFallback<T>();
+    }
+}
+
+// Счетчики переносов копированием во всей программе
+struct CopyFallbackCounters {
+    std::atomic<size_t> operations{0};
+    std::atomic<size_t> elements{0};
+};
+
+inline CopyFallbackCounters& GetCopyFallbackCounters() noexcept {
+    static CopyFallbackCounters counters;
+    return counters;
+}
+
+// Учитывает перенос count элементов копированием
+inline void RecordCopyFallback(size_t count) noexcept {
+    CopyFallbackCounters& counters = GetCopyFallbackCounters();
+    counters.operations.fetch_add(1, std::memory_order_relaxed);
+    counters.elements.fetch_add(count, std::memory_order_relaxed);
+}
+
+/**
+ * Возвращает индекс первого элемента части chunk при разбиении count элементов на chunks частей
+*/
+inline size_t ChunkBegin(size_t count, size_t chunks, size_t chunk) noexcept {
+    return count / chunks * chunk + std::min(chunk, count % chunks);
+}
+
+/**
+ * Конструирует count элементов в to, вызывая construct(offset, n) для частей диапазона
+ * согласно политике Exec. При исключении construct должна разрушить созданные ею элементы.
+ * Если исключение выбросила хотя бы одна часть, элементы остальных частей разрушаются,
+ * а первое исключение пробрасывается вызывающему
+*/
+template <typename Exec, typename T, typename Construct>
+void ConstructChunks(T* to, size_t count, Construct construct) {
+    const size_t chunks = Exec::ChunkCount(count);
+    if (chunks <= 1) {
+        construct(size_t{0}, count);
+        return;
+    }
+
+    std::unique_ptr<bool[]> done(new bool[chunks]());
+    std::exception_ptr error;
+    std::atomic_flag has_error = ATOMIC_FLAG_INIT;
+    auto task = [&](size_t chunk) noexcept {
+        const size_t begin = ChunkBegin(count, chunks, chunk);
+        try {
+            construct(begin, ChunkBegin(count, chunks, chunk + 1) - begin);
+            done[chunk] = true;
+        }
+        catch (...) {
+            if (!has_error.test_and_set()) {
+                error = std::current_exception();
+            }
+        }
+    };
+    Exec::Run(chunks, task);
+
+    if (error) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            if (done[chunk]) {
+                const size_t begin = ChunkBegin(count, chunks, chunk);
+                std::destroy_n(to + begin, ChunkBegin(count, chunks, chunk + 1) - begin);
+            }
+        }
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * Разрушает count элементов, начиная с data, частями согласно политике Exec
+*/
+template <typename Exec, typename T>
+void DestroyChunks(T* data, size_t count) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        const size_t chunks = Exec::ChunkCount(count);
+        if (chunks <= 1) {
+            std::destroy_n(data, count);
+            return;
+        }
+        auto task = [data, count, chunks](size_t chunk) noexcept {
+            const size_t begin = ChunkBegin(count, chunks, chunk);
+            std::destroy_n(data + begin, ChunkBegin(count, chunks, chunk + 1) - begin);
+        };
+        Exec::Run(chunks, task);
+    }
+}
+
+/**
+ * Безопасно перемещает или копирует n элементов из одного участка памяти в другой,
+ * очищает содержимое from. Используется всеми контейнерами на основе RawMemory.
+ * Политика Exec позволяет переносить большие массивы в нескольких потоках
+*/
+template <typename Exec = SequentialExecution, typename T>
+void MoveElements(T* from, size_t size, T* to) {
+    // Тривиально перемещаемые объекты переносим одним блоком памяти,
+    // деструкторы исходных объектов в этом случае не вызываются
+    if constexpr (IsTriviallyRelocatable_v<T>) {
+        if (size != 0) {
+            ConstructChunks<Exec>(to, size, [from, to](size_t offset, size_t n) {
+                std::memcpy(static_cast<void*>(to + offset), static_cast<const void*>(from + offset), n * sizeof(T));
+            });
+        }
+    }
+    else {
+        // Если объект типа T имеет noexcept move-конструктор или не имеет конструктора копирования - 
+        // перемещаем объекты из from в to, в противном случае копируем их
+        if constexpr (MOVE_ELEMENTS_COPIES<T>) {
+            if (size != 0) {
+                RecordCopyFallback(size);
+            }
+        }
+        ConstructChunks<Exec>(to, size, [from, to](size_t offset, size_t n) {
+            if constexpr (!MOVE_ELEMENTS_COPIES<T>) {
+                std::uninitialized_move_n(from + offset, n, to + offset);
+            }
+            else {
+                std::uninitialized_copy_n(from + offset, n, to + offset);
+            }
+        });
+        // Освобождаем старую память
+        DestroyChunks<Exec>(from, size);
+    }
+}
+
+/**
+ * Перемещает или копирует size элементов из from в to, оставляя в to gap_size свободных ячеек
+ * начиная с позиции gap. Если при копировании выбрасывается исключение, содержимое from сохраняется.
+ * Перемещение выполняется частями согласно политике Exec, копирование - последовательно
+*/
+template <typename Exec = SequentialExecution, typename T>
+void MoveElementsWithGap(T* from, size_t size, size_t gap, T* to, size_t gap_size = 1) {
+    if constexpr (!MOVE_ELEMENTS_COPIES<T>) {
+        MoveElements<Exec>(from, gap, to);
+        MoveElements<Exec>(from + gap, size - gap, to + (gap + gap_size));
+    }
+    else {
+        if (size != 0) {
+            RecordCopyFallback(size);
+        }
+        // Исходные объекты удаляются только после успешного копирования обеих частей
+        std::uninitialized_copy_n(from, gap, to);
+        try {
+            std::uninitialized_copy_n(from + gap, size - gap, to + (gap + gap_size));
+        }
+        catch (...) {
+            std::destroy_n(to, gap);
+            throw;
+        }
+        std::destroy_n(from, size);
+    }
+}
+
+/**
+ * Признак того, что аргументы Emplace - единственное значение типа T
+*/
+template <typename T, typename... Types>
+inline constexpr bool IS_SINGLE_VALUE = false;
+
+template <typename T, typename Type>
+inline constexpr bool IS_SINGLE_VALUE<T, Type> = std::is_same_v<std::decay_t<Type>, T>;
+
+/**
+ * Разбиение индексов на сегменты геометрически растущего размера: сегмент k вмещает
+ * FIRST_SIZE * 2^k элементов. Сегменты не перевыделяются при росте, а номер сегмента
+ * и смещение в нем вычисляются за O(1) по старшему единичному биту индекса
+*/
+template <size_t FirstBits>
+struct SegmentLayout {
+    static constexpr size_t FIRST_SIZE = size_t{1} << FirstBits;
+    // Сегментов хватает на любой индекс, представимый в size_t
+    static constexpr size_t MAX_SEGMENTS = sizeof(size_t) * 8 - FirstBits;
+
+    // Номер сегмента, хранящего элемент с индексом index
+    static size_t SegmentIndex(size_t index) noexcept {
+        // Номер старшего единичного бита числа index + FIRST_SIZE
+        const size_t shifted = (index >> FirstBits) + 1;
+#if defined(__GNUC__) || defined(__clang__)
+        return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(static_cast<unsigned long long>(shifted));
+#else
+        size_t segment = 0;
+        for (size_t value = shifted; value > 1; value >>= 1) {
+            ++segment;
+        }
+        return segment;
+#endif
+    }
+    // Смещение элемента с индексом index внутри сегмента segment
+    static size_t SegmentOffset(size_t index, size_t segment) noexcept {
+        // Сегменты до segment вмещают в сумме SegmentSize(segment) - FIRST_SIZE элементов
+        return index + FIRST_SIZE - SegmentSize(segment);
+    }
+    // Вместимость сегмента segment
+    static size_t SegmentSize(size_t segment) noexcept {
+        return FIRST_SIZE << segment;
+    }
+};
+
+/**
+ * Сообщает компилятору, что указатель выровнен по границе Alignment байт
+*/
+template <size_t Alignment, typename T>
+T* AssumeAligned(T* ptr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<T*>(__builtin_assume_aligned(ptr, Alignment));
+#else
+    return ptr;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * Статистика переносов элементов копированием вместо перемещения во всех
+ * контейнерах программы: количество операций переноса и скопированных элементов
+*/
+struct CopyFallbackStats {
+    size_t operations = 0;
+    size_t elements = 0;
+};
+
+/**
+ * Возвращает статистику переносов копированием
+*/
+inline CopyFallbackStats GetCopyFallbackStats() noexcept {
+    const detail::CopyFallbackCounters& counters = detail::GetCopyFallbackCounters();
+    return {counters.operations.load(std::memory_order_relaxed), counters.elements.load(std::memory_order_relaxed)};
+}
+/**
+ * Обнуляет статистику переносов копированием
+*/
+inline void ResetCopyFallbackStats() noexcept {
+    detail::CopyFallbackCounters& counters = detail::GetCopyFallbackCounters();
+    counters.operations.store(0, std::memory_order_relaxed);
+    counters.elements.store(0, std::memory_order_relaxed);
+}
+
+template <typename T, typename Alloc = std::allocator<T>, typename Traits = DefaultVectorTraits>
+class Vector : private Traits::StatsPolicy {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using StatsPolicy = typename Traits::StatsPolicy;
+    using CheckPolicy = typename Traits::CheckPolicy;
+    using Memory = RawMemory<T, Alloc, CheckPolicy>;
+
 public:
     using iterator = T*;
     using const_iterator = const T*;
+    using allocator_type = Alloc;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>, 
+        "Vector<T, Alloc> requires Alloc::value_type to be T");
+
+    // Выравнивание буфера вектора, гарантированное аллокатором
+    static constexpr size_t ALIGNMENT = AllocatorAlignment_v<Alloc>;
 
-    Vector() noexcept;
-    explicit Vector(size_t size);
+    Vector() noexcept(noexcept(Alloc()));
+    explicit Vector(const Alloc& alloc) noexcept;
+    explicit Vector(size_t size, const Alloc& alloc = Alloc());
+    Vector(size_t size, DefaultInitT, const Alloc& alloc = Alloc());
     Vector(const Vector& other);
+    Vector(const Vector& other, const Alloc& alloc);
     Vector(Vector&& other) noexcept;
 
     Vector& operator=(const Vector& other);
-    Vector& operator=(Vector&& other) noexcept;
+    Vector& operator=(Vector&& other) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value 
+        || AllocTraits::is_always_equal::value);
 
     ~Vector() noexcept;
 
     void Resize(size_t new_size);
+    void ResizeDefaultInit(size_t new_size);
+    template <typename Operation>
+    void ResizeAndOverwrite(size_t n, Operation op);
     void Reserve(size_t n);
+    void ShrinkToFit();
+    void Clear() noexcept;
+    void Release() noexcept;
 
     template <typename... Types>
     T& EmplaceBack(Types&&... args);
@@ -39,14 +700,32 @@ public:
     template <typename ValueType>
     iterator Insert(const_iterator pos, ValueType&& value);
 
-    void PopBack() noexcept;
+    template <typename InputIt>
+    iterator InsertRange(const_iterator pos, InputIt first, InputIt last);
+    template <typename InputIt>
+    void AppendRange(InputIt first, InputIt last);
+    template <typename InputIt>
+    void Assign(InputIt first, InputIt last);
+
+    WriteBuffer<T> GetWriteBuffer(size_t min_n);
+    void Commit(size_t n) noexcept(CheckPolicy::NOTHROW);
+
+    void PopBack() noexcept(CheckPolicy::NOTHROW);
     iterator Erase(const_iterator pos);
+    iterator EraseRange(const_iterator first, const_iterator last);
+    iterator SwapRemove(const_iterator pos);
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred);
+    template <typename Predicate>
+    size_t RemoveIf(Predicate pred);
 
     size_t Size() const noexcept;
     size_t Capacity() const noexcept;
 
-    const T& operator[](size_t index) const noexcept;
-    T& operator[](size_t index) noexcept;
+    const T& operator[](size_t index) const noexcept(CheckPolicy::NOTHROW);
+    T& operator[](size_t index) noexcept(CheckPolicy::NOTHROW);
+    const T& UncheckedAt(size_t index) const noexcept;
+    T& UncheckedAt(size_t index) noexcept;
 
     iterator begin() noexcept;
     iterator end() noexcept;
@@ -55,47 +734,109 @@ public:
     const_iterator cbegin() const noexcept;
     const_iterator cend() const noexcept;
 
+    T* Data() noexcept;
+    const T* Data() const noexcept;
+    template <size_t Alignment = ALIGNMENT>
+    T* AssumeAligned() noexcept(CheckPolicy::NOTHROW);
+    template <size_t Alignment = ALIGNMENT>
+    const T* AssumeAligned() const noexcept(CheckPolicy::NOTHROW);
+
     void Swap(Vector& other) noexcept;
 
+    Alloc GetAllocator() const noexcept;
+    const StatsPolicy& Stats() const noexcept;
+
 private:
-    RawMemory<T> data_; // Объект управления сырой памятью вектора
+    Memory data_; // Объект управления сырой памятью вектора
     size_t size_ = 0; // Размер вектор
 
-    static void MoveElements(T* from, size_t size, T* to);
+    // Буфер можно расширять средствами аллокатора, не перенося элементы поштучно
+    static constexpr bool CAN_REALLOCATE = IsTriviallyRelocatable_v<T> && HasReallocate_v<Alloc>;
+
+    size_t NextCapacity(size_t required) const noexcept;
+    void Reallocate(size_t new_capacity);
+    void ApplyShrinkPolicy() noexcept;
+
+    template <typename Value>
+    void ShiftAndAssign(size_t index, Value&& value);
+
+    void RecordAllocation(size_t old_capacity, size_t new_capacity) noexcept;
+    void RecordRelocation(size_t count) noexcept;
+
+    using ExecutionPolicy = typename Traits::ExecutionPolicy;
+
 };
 
 /**
  * Конструктор по умолчанию
 */
-template <typename T>
-Vector<T>::Vector() noexcept
+template <typename T, typename Alloc, typename Traits>
+Vector<T, Alloc, Traits>::Vector() noexcept(noexcept(Alloc()))
     : data_()
 {}
+/**
+ * Конструктор, создает пустой вектор, использующий заданный аллокатор
+*/
+template <typename T, typename Alloc, typename Traits>
+Vector<T, Alloc, Traits>::Vector(const Alloc& alloc) noexcept
+    : data_(alloc)
+{}
 /**
  * Конструктор, создает вектор заданного размера
 */
-template <typename T>
-Vector<T>::Vector(size_t size) 
-    : data_(size)
+template <typename T, typename Alloc, typename Traits>
+Vector<T, Alloc, Traits>::Vector(size_t size, const Alloc& alloc) 
+    : data_(size, alloc)
     , size_(size)
 {
-    std::uninitialized_value_construct_n(data_.GetAddress(), size_);
+    T* data = data_.GetAddress();
+    detail::ConstructChunks<ExecutionPolicy>(data, size_, [data](size_t offset, size_t n) {
+        std::uninitialized_value_construct_n(data + offset, n);
+    });
+    RecordAllocation(0, size);
 }
 /**
- * Конструктор, создает копию передаваемого вектора
+ * Конструктор, создает вектор заданного размера, инициализируя элементы по умолчанию
 */
-template <typename T>
-Vector<T>::Vector(const Vector& other) 
-    : data_(other.Size())
+template <typename T, typename Alloc, typename Traits>
+Vector<T, Alloc, Traits>::Vector(size_t size, DefaultInitT, const Alloc& alloc) 
+    : data_(size, alloc)
+    , size_(size)
+{
+    T* data = data_.GetAddress();
+    detail::ConstructChunks<ExecutionPolicy>(data, size_, [data](size_t offset, size_t n) {
+        std::uninitialized_default_construct_n(data + offset, n);
+    });
+    RecordAllocation(0, size);
+}
+/**
+ * Конструктор, создает копию передаваемого вектора,
+ * аллокатор выбирается через select_on_container_copy_construction
+*/
+template <typename T, typename Alloc, typename Traits>
+Vector<T, Alloc, Traits>::Vector(const Vector& other) 
+    : Vector(other, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator()))
+{}
+/**
+ * Конструктор, создает копию передаваемого вектора в памяти заданного аллокатора
+*/
+template <typename T, typename Alloc, typename Traits>
+Vector<T, Alloc, Traits>::Vector(const Vector& other, const Alloc& alloc) 
+    : data_(other.Size(), alloc)
     , size_(other.Size()) 
 {
-    std::uninitialized_copy_n(other.data_.GetAddress(), size_, data_.GetAddress());
+    const T* from = other.data_.GetAddress();
+    T* to = data_.GetAddress();
+    detail::ConstructChunks<ExecutionPolicy>(to, size_, [from, to](size_t offset, size_t n) {
+        std::uninitialized_copy_n(from + offset, n, to + offset);
+    });
+    RecordAllocation(0, size_);
 }
 /**
  * Конструктор перемещения
 */
-template <typename T>
-Vector<T>::Vector(Vector&& other) noexcept
+template <typename T, typename Alloc, typename Traits>
+Vector<T, Alloc, Traits>::Vector(Vector&& other) noexcept
     : data_(std::move(other.data_))
     , size_(std::move(other.size_))
 {
@@ -103,49 +844,112 @@ Vector<T>::Vector(Vector&& other) noexcept
 }
 
 /**
- * Оператор копирующего присваивания
+ * Оператор копирующего присваивания. Тривиально копируемые элементы копируются одним
+ * memcpy, остальные присваиваются существующим элементам, в том числе после расширения
+ * буфера. Если копирование элемента выбросит исключение, вектор остается в корректном,
+ * но неопределенном состоянии
 */
-template <typename T>
-Vector<T>& Vector<T>::operator=(const Vector& other) {
+template <typename T, typename Alloc, typename Traits>
+Vector<T, Alloc, Traits>& Vector<T, Alloc, Traits>::operator=(const Vector& other) {
     if (this == &other) {
         return *this;
     }
 
-    // Если вместимость вектора меньше размера присваиваемого вектора - 
-    // применим идиому copy-and-swap
-    if (data_.Capacity() < other.size_) {
-        Vector new_vector(other);
-        Swap(new_vector);
+    // Если аллокатор распространяется при копировании и отличается от текущего - 
+    // освобождаем память текущим аллокатором и перенимаем аллокатор other
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value 
+            && !AllocTraits::is_always_equal::value) {
+        if (data_.GetAllocator() != other.data_.GetAllocator()) {
+            std::destroy_n(data_.GetAddress(), size_);
+            size_ = 0;
+            data_.ResetAllocator(other.data_.GetAllocator());
+        }
+    }
+
+    const size_t other_size = other.size_;
+    const T* from = other.data_.GetAddress();
+
+    // Тривиально копируемые элементы не нужно ни разрушать, ни конструировать -
+    // прежнее содержимое перезаписывается одним блоком памяти
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (data_.Capacity() < other_size) {
+            // Буфер расширяется аллокатором на месте, если он это умеет
+            if constexpr (CAN_REALLOCATE) {
+                Reallocate(other_size);
+            }
+            else {
+                Memory new_data(other_size, data_.GetAllocator());
+                RecordAllocation(data_.Capacity(), new_data.Capacity());
+                data_.Swap(new_data);
+            }
+        }
+        if (other_size != 0) {
+            std::memcpy(static_cast<void*>(data_.GetAddress()), static_cast<const void*>(from),
+                other_size * sizeof(T));
+        }
+        size_ = other_size;
         return *this;
     }
-    // Иначе - копируем элементы из rhs, создаем при необходимости новые
+
+    if (data_.Capacity() < other_size) {
+        // Если элементы переносятся в новый буфер без копирования - расширяем его и
+        // присваиваем существующим элементам, повторно используя их ресурсы (например,
+        // память строк). Иначе перенос стоит столько же, сколько копирование, и
+        // применяется идиома copy-and-swap
+        if constexpr (detail::MOVE_ELEMENTS_COPIES<T>) {
+            Vector new_vector(other, data_.GetAllocator());
+            RecordAllocation(data_.Capacity(), new_vector.Capacity());
+            Swap(new_vector);
+            return *this;
+        }
+        else {
+            Reallocate(other_size);
+        }
+    }
+
+    // Копируем элементы из other в существующие, создаем при необходимости новые
     // или удаляем старые
-    for (size_t i = 0; i < std::min(size_, other.size_); ++i) {
-        data_[i] = other[i];
-    }
-    // Если текущий размер меньше копируемого - создаем новые элементы
-    if (size_ < other.size_) {
-        std::uninitialized_copy_n(
-            other.data_.GetAddress() + size_,
-            other.size_ - size_,
-            data_.GetAddress() + size_
-        );
-    }
-    // Иначе - удаляем лишние
+    const size_t common_size = std::min(size_, other_size);
+    std::copy_n(from, common_size, data_.GetAddress());
+    if (size_ < other_size) {
+        std::uninitialized_copy_n(from + size_, other_size - size_, data_.GetAddress() + size_);
+    }
     else {
-        std::destroy_n(data_.GetAddress() + size_, size_ - other.size_);
+        std::destroy_n(data_.GetAddress() + other_size, size_ - other_size);
     }
-    
-    // Обновляем размер вектора
-    size_ = other.size_;
+    size_ = other_size;
 
     return *this;
 }
 /**
  * Оператор перемещающего присваивания
 */
-template <typename T>
-Vector<T>& Vector<T>::operator=(Vector&& other) noexcept {
+template <typename T, typename Alloc, typename Traits>
+Vector<T, Alloc, Traits>& Vector<T, Alloc, Traits>::operator=(Vector&& other) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value 
+        || AllocTraits::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+
+    std::destroy_n(data_.GetAddress(), size_);
+    size_ = 0;
+
+    // Если аллокаторы не распространяются при перемещении и различны - память other
+    // не может быть освобождена текущим аллокатором, поэтому перемещаем элементы поштучно
+    if constexpr (!AllocTraits::propagate_on_container_move_assignment::value 
+            && !AllocTraits::is_always_equal::value) {
+        if (data_.GetAllocator() != other.data_.GetAllocator()) {
+            Reserve(other.size_);
+            std::uninitialized_move_n(other.data_.GetAddress(), other.size_, data_.GetAddress());
+            size_ = other.size_;
+
+            std::destroy_n(other.data_.GetAddress(), other.size_);
+            other.size_ = 0;
+            return *this;
+        }
+    }
+
     data_ = std::move(other.data_);
     size_ = std::move(other.size_);
     other.size_ = 0;
@@ -157,16 +961,16 @@ Vector<T>& Vector<T>::operator=(Vector&& other) noexcept {
  * Деструктор, вызывает деструкторы хранящихся в вектор объектов,
  * зарезервированная память автоматически освободится деструктором ~RawMemory()
 */
-template <typename T>
-Vector<T>::~Vector() noexcept {
-    std::destroy_n(data_.GetAddress(), size_);
+template <typename T, typename Alloc, typename Traits>
+Vector<T, Alloc, Traits>::~Vector() noexcept {
+    detail::DestroyChunks<ExecutionPolicy>(data_.GetAddress(), size_);
 }
 
 /**
  * Изменяет размер вектора
 */
-template <typename T>
-void Vector<T>::Resize(size_t new_size) {
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::Resize(size_t new_size) {
     // Если новый размер равен текущему - делать нечего
     if (size_ == new_size) {
         return;
@@ -184,43 +988,145 @@ void Vector<T>::Resize(size_t new_size) {
     }
     // Обновляем размер вектора
     size_ = new_size;
+    ApplyShrinkPolicy();
+}
+/**
+ * Изменяет размер вектора, новые элементы инициализируются по умолчанию
+*/
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::ResizeDefaultInit(size_t new_size) {
+    if (size_ > new_size) {
+        std::destroy_n(data_ + new_size, size_ - new_size);
+    }
+    else {
+        Reserve(new_size);
+        std::uninitialized_default_construct_n(data_ + size_, new_size - size_);
+    }
+    size_ = new_size;
+    ApplyShrinkPolicy();
+}
+/**
+ * Расширяет вектор до n элементов, инициализируя новые по умолчанию, и передает буфер
+ * в op(T* data, size_t n) для перезаписи. Операция возвращает итоговый размер вектора,
+ * не превышающий n. Если операция выбросит исключение, вектор сохранит прежний размер
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename Operation>
+void Vector<T, Alloc, Traits>::ResizeAndOverwrite(size_t n, Operation op) {
+    const size_t old_size = size_;
+    if (n > size_) {
+        ResizeDefaultInit(n);
+    }
+
+    size_t new_size = 0;
+    try {
+        new_size = static_cast<size_t>(std::move(op)(data_.GetAddress(), n));
+    }
+    catch (...) {
+        ResizeDefaultInit(std::min(old_size, size_));
+        throw;
+    }
+    CheckPolicy::Check(new_size <= n, "ResizeAndOverwrite result exceeds n");
+    ResizeDefaultInit(std::min(new_size, n));
 }
 /**
  * Резервирует памяти под указанное количество элементов вектора
 */
-template <typename T>
-void Vector<T>::Reserve(size_t new_capacity) {
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::Reserve(size_t new_capacity) {
     if (new_capacity <= data_.Capacity()) {
         return;
     }
 
-    // Аллоцируем новый участок памяти размером new_capacity
-    RawMemory<T> new_data(new_capacity);
+    Reallocate(new_capacity);
+}
+/**
+ * Возвращает неинициализированный хвост буфера не меньше min_n элементов, расширяя
+ * буфер по политике роста. Производитель записывает элементы прямо в хвост,
+ * без промежуточного буфера, и публикует записанное вызовом Commit.
+ * Повторный вызов без Commit возвращает тот же хвост, если расширение не понадобилось
+*/
+template <typename T, typename Alloc, typename Traits>
+WriteBuffer<T> Vector<T, Alloc, Traits>::GetWriteBuffer(size_t min_n) {
+    static_assert(std::is_trivially_copyable_v<T>, "GetWriteBuffer requires trivially copyable T");
 
-    MoveElements(data_.GetAddress(), size_, new_data.GetAddress());
-    data_.Swap(new_data);
+    if (data_.Capacity() - size_ < min_n) {
+        Reallocate(NextCapacity(size_ + min_n));
+    }
+    return {data_ + size_, data_.Capacity() - size_};
+}
+/**
+ * Добавляет в конец вектора n элементов, записанных в буфер GetWriteBuffer
+*/
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::Commit(size_t n) noexcept(CheckPolicy::NOTHROW) {
+    static_assert(std::is_trivially_copyable_v<T>, "Commit requires trivially copyable T");
+
+    CheckPolicy::Check(n <= data_.Capacity() - size_, "Commit exceeds the write buffer");
+    size_ += n;
+}
+/**
+ * Уменьшает вместимость вектора до его размера
+*/
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::ShrinkToFit() {
+    if (size_ == data_.Capacity()) {
+        return;
+    }
+    if (size_ == 0) {
+        Release();
+        return;
+    }
+
+    Reallocate(size_);
+}
+/**
+ * Удаляет все элементы вектора, сохраняя его вместимость
+*/
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::Clear() noexcept {
+    detail::DestroyChunks<ExecutionPolicy>(data_.GetAddress(), size_);
+    size_ = 0;
+}
+/**
+ * Удаляет все элементы вектора и освобождает его память
+*/
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::Release() noexcept {
+    Clear();
+    Memory empty(data_.GetAllocator());
+    data_.Swap(empty);
 }
 
 /**
  * Передает аргументы конструктору типа T по forwarding-ссылке,
  * полученный элемент добавляется в конец вектора
 */
-template <typename T>
+template <typename T, typename Alloc, typename Traits>
 template <typename... Types>
-T& Vector<T>::EmplaceBack(Types&&... args) {
+T& Vector<T, Alloc, Traits>::EmplaceBack(Types&&... args) {
     // Если вместимость больше размера вектора - создаем новый элемент
     if (size_ < Capacity()) {
         new(data_ + size_) T(std::forward<Types>(args)...);
     }
+    // Если буфер расширяется аллокатором - создаем элемент до расширения, 
+    // так как аргументы могут ссылаться на элементы вектора
+    else if constexpr (CAN_REALLOCATE) {
+        T temp(std::forward<Types>(args)...);
+        const size_t old_capacity = data_.Capacity();
+        data_.Reallocate(NextCapacity(size_ + 1));
+        RecordAllocation(old_capacity, data_.Capacity());
+        new(data_ + size_) T(std::move(temp));
+    }
     // Иначе - переаллоцируем новый участок памяти и вносим элемент туда
     else {
         // Аллоцируем новый участок памяти размером new_capacity
-        RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
+        Memory new_data(NextCapacity(size_ + 1), data_.GetAllocator());
         
         new(new_data + size_) T(std::forward<Types>(args)...);
         // Перемещаем элементы вектора на новый участок
         try {
-            MoveElements(data_.GetAddress(), size_, new_data.GetAddress());
+            detail::MoveElements<ExecutionPolicy>(data_.GetAddress(), size_, new_data.GetAddress());
         }
         catch (...) {
             // В случае выбрасывания исключения методом MoveElements
@@ -228,6 +1134,8 @@ T& Vector<T>::EmplaceBack(Types&&... args) {
             std::destroy_at(new_data + size_);
             throw;
         }
+        RecordAllocation(data_.Capacity(), new_data.Capacity());
+        RecordRelocation(size_);
         data_.Swap(new_data);
     }
 
@@ -238,9 +1146,9 @@ T& Vector<T>::EmplaceBack(Types&&... args) {
  * Копирует или перемещает передаваемый элемент в конец вектора 
  * в зависимости от типа объекта, принимая его по forwarding-ссылке
 */
-template <typename T>
+template <typename T, typename Alloc, typename Traits>
 template <typename ValueType>
-void Vector<T>::PushBack(ValueType&& value) {
+void Vector<T, Alloc, Traits>::PushBack(ValueType&& value) {
     EmplaceBack(std::forward<ValueType>(value));
 }
 
@@ -248,62 +1156,80 @@ void Vector<T>::PushBack(ValueType&& value) {
  * Копирует или перемещает передаваемый элемент в позицию pos
  * в зависимости от типа объекта, принимая его по forwarding-ссылке
 */
-template <typename T>
+template <typename T, typename Alloc, typename Traits>
 template <typename ValueType>
-typename Vector<T>::iterator Vector<T>::Insert(const_iterator pos, ValueType&& value) {
+typename Vector<T, Alloc, Traits>::iterator Vector<T, Alloc, Traits>::Insert(const_iterator pos, ValueType&& value) {
     return Emplace(pos, std::forward<ValueType>(value));
 }
 /**
  * Передает аргументы конструктору типа T по forwarding-ссылке,
  * вставляет полученный элемент в позицию pos, возвращает итератор на него
 */
-template <typename T>
+template <typename T, typename Alloc, typename Traits>
 template <typename... Types>
-typename Vector<T>::iterator Vector<T>::Emplace(const_iterator pos, Types&&... args) {
-    assert((0 <= pos - begin()) && (static_cast<size_t>(pos - begin()) <= size_));
+typename Vector<T, Alloc, Traits>::iterator Vector<T, Alloc, Traits>::Emplace(const_iterator pos, Types&&... args) {
+    CheckPolicy::Check(cbegin() <= pos && pos <= cend(), "Emplace position is out of range");
 
-    // Если итератор указывает на конец - вызовем метод EmplaceBack
-    if (pos == end()) {
-        EmplaceBack(std::forward<Types>(args)...);
+    // Вставка в конец не требует сдвига элементов
+    if (pos == cend()) {
+        return std::addressof(EmplaceBack(std::forward<Types>(args)...));
     }
 
-    size_t index = pos - begin();
-    // Если вместимость больше размера вектора - создаем временный объект, сдвигаем данные
-    // вектора после pos на один вправо, и вставляем элемент на место pos
-    if (size_ < Capacity()) {
-        // Создаем временный объект
-        T temp(std::forward<Types>(args)...);
-
-        // Сдвигаем элементы на один вправо
-        new(end()) T(std::move((*this)[Size() - 1]));
-        std::move_backward(begin() + index, end() - 1, end());
-
-        data_[index] = std::move(temp);
+    const size_t index = pos - cbegin();
+    // Если буфер расширяется аллокатором - создаем элемент до расширения, так как аргументы
+    // могут ссылаться на элементы вектора, затем сдвигаем хвост побайтово
+    if constexpr (CAN_REALLOCATE) {
+        alignas(T) unsigned char buffer[sizeof(T)];
+        T* temp = new (buffer) T(std::forward<Types>(args)...);
+        if (size_ == Capacity()) {
+            try {
+                Reallocate(NextCapacity(size_ + 1));
+            }
+            catch (...) {
+                std::destroy_at(temp);
+                throw;
+            }
+        }
+        std::memmove(static_cast<void*>(data_ + (index + 1)), static_cast<const void*>(data_ + index),
+            (size_ - index) * sizeof(T));
+        std::memcpy(static_cast<void*>(data_ + index), static_cast<const void*>(buffer), sizeof(T));
     }
-    // Иначе - аллоцируем новую память, вставляем новый элемент на новую позицию,
-    // перемещаем элементы на новые места
-    else {
-        RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-        new(new_data + index) T(std::forward<Types>(args)...);
-
-        // Перемещаем первую половину элементов в диапозоне [begin(), index)
-        try {
-            MoveElements(data_.GetAddress(), index, new_data.GetAddress());
+    else if (size_ < Capacity()) {
+        if constexpr (IsTriviallyRelocatable_v<T>) {
+            // Объект конструируется один раз в неинициализированном буфере, пока аргументы
+            // еще могут ссылаться на элементы вектора, затем переносится в освобожденную
+            // сдвигом ячейку побайтово
+            alignas(T) unsigned char buffer[sizeof(T)];
+            new (buffer) T(std::forward<Types>(args)...);
+            std::memmove(static_cast<void*>(data_ + (index + 1)), static_cast<const void*>(data_ + index),
+                (size_ - index) * sizeof(T));
+            std::memcpy(static_cast<void*>(data_ + index), static_cast<const void*>(buffer), sizeof(T));
         }
-        catch (...) {
-            std::destroy_at(new_data + index);
-            throw;
+        else if constexpr (detail::IS_SINGLE_VALUE<T, Types...>) {
+            ShiftAndAssign(index, std::forward<Types>(args)...);
         }
-
-        // Перемещаем вторую половину элементов в диапозоне [size_ - index, end())
+        else {
+            T temp(std::forward<Types>(args)...);
+            new (end()) T(std::move(data_[size_ - 1]));
+            std::move_backward(begin() + index, end() - 1, end());
+            data_[index] = std::move(temp);
+        }
+    }
+    // Иначе - аллоцируем новую память, создаем новый элемент на его позиции
+    // и переносим остальные элементы вокруг него
+    else {
+        Memory new_data(NextCapacity(size_ + 1), data_.GetAllocator());
+        new (new_data + index) T(std::forward<Types>(args)...);
         try {
-            MoveElements(data_ + index, size_ - index, new_data + (index + 1));
+            detail::MoveElementsWithGap<ExecutionPolicy>(data_.GetAddress(), size_, index, new_data.GetAddress());
         }
         catch (...) {
-            std::destroy_n(data_.GetAddress(), index + 1);
+            std::destroy_at(new_data + index);
             throw;
         }
 
+        RecordAllocation(data_.Capacity(), new_data.Capacity());
+        RecordRelocation(size_);
         data_.Swap(new_data);
     }
 
@@ -311,147 +1237,597 @@ typename Vector<T>::iterator Vector<T>::Emplace(const_iterator pos, Types&&... a
     return begin() + index;
 }
 
+/**
+ * Вставляет элементы диапазона [first, last) в позицию pos, возвращает итератор
+ * на первый вставленный элемент. Вместимость вычисляется и хвост вектора сдвигается 
+ * один раз на весь диапазон. Диапазон не должен ссылаться на элементы самого вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename InputIt>
+typename Vector<T, Alloc, Traits>::iterator Vector<T, Alloc, Traits>::InsertRange(
+        const_iterator pos, InputIt first, InputIt last) {
+    CheckPolicy::Check(cbegin() <= pos && pos <= cend(), "InsertRange position is out of range");
+
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+    using Reference = typename std::iterator_traits<InputIt>::reference;
+
+    const size_t index = pos - cbegin();
+
+    // Для однопроходных итераторов количество элементов заранее неизвестно - 
+    // добавляем их в конец и переставляем на место одним поворотом
+    if constexpr (!std::is_base_of_v<std::forward_iterator_tag, Category>) {
+        const size_t old_size = size_;
+        for (; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+        std::rotate(begin() + index, begin() + old_size, end());
+        return begin() + index;
+    }
+    else {
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+        if (count == 0) {
+            return begin() + index;
+        }
+
+        // Если буфер расширяется аллокатором - расширяем его и вставляем диапазон на месте
+        if constexpr (CAN_REALLOCATE) {
+            if (size_ + count > Capacity()) {
+                Reallocate(NextCapacity(size_ + count));
+            }
+        }
+        // Если места недостаточно - создаем элементы диапазона в новой памяти
+        // и переносим остальные элементы вокруг них
+        if (size_ + count > Capacity()) {
+            Memory new_data(NextCapacity(size_ + count), data_.GetAllocator());
+            std::uninitialized_copy(first, last, new_data + index);
+            try {
+                detail::MoveElementsWithGap<ExecutionPolicy>(data_.GetAddress(), size_, index, new_data.GetAddress(), count);
+            }
+            catch (...) {
+                std::destroy_n(new_data + index, count);
+                throw;
+            }
+            RecordAllocation(data_.Capacity(), new_data.Capacity());
+            RecordRelocation(size_);
+            data_.Swap(new_data);
+            size_ += count;
+        }
+        // Хвост тривиально перемещаемых объектов сдвигаем одним блоком памяти
+        else if constexpr (IsTriviallyRelocatable_v<T> && std::is_nothrow_constructible_v<T, Reference>) {
+            std::memmove(static_cast<void*>(data_ + (index + count)), static_cast<const void*>(data_ + index),
+                (size_ - index) * sizeof(T));
+            std::uninitialized_copy(first, last, data_ + index);
+            size_ += count;
+        }
+        // Иначе - часть хвоста переносим в неинициализированную память за концом вектора,
+        // остальное сдвигаем присваиванием
+        else {
+            const size_t elems_after = size_ - index;
+            T* const old_end = end();
+            if (elems_after > count) {
+                std::uninitialized_move(old_end - count, old_end, old_end);
+                size_ += count;
+                std::move_backward(begin() + index, old_end - count, old_end);
+                std::copy(first, last, begin() + index);
+            }
+            else {
+                InputIt mid = std::next(first, elems_after);
+                std::uninitialized_copy(mid, last, old_end);
+                size_ += count - elems_after;
+                std::uninitialized_move(begin() + index, old_end, end());
+                size_ += elems_after;
+                std::copy(first, mid, begin() + index);
+            }
+        }
+        return begin() + index;
+    }
+}
+/**
+ * Добавляет элементы диапазона [first, last) в конец вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename InputIt>
+void Vector<T, Alloc, Traits>::AppendRange(InputIt first, InputIt last) {
+    InsertRange(cend(), first, last);
+}
+/**
+ * Заменяет содержимое вектора элементами диапазона [first, last)
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename InputIt>
+void Vector<T, Alloc, Traits>::Assign(InputIt first, InputIt last) {
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+
+        // Если буфер расширяется аллокатором - расширяем его и присваиваем на месте
+        if constexpr (CAN_REALLOCATE) {
+            if (count > Capacity()) {
+                Reallocate(count);
+            }
+        }
+        // Если вместимости недостаточно - копируем диапазон в новую память
+        if (count > Capacity()) {
+            Memory new_data(count, data_.GetAllocator());
+            std::uninitialized_copy(first, last, new_data.GetAddress());
+
+            std::destroy_n(data_.GetAddress(), size_);
+            RecordAllocation(data_.Capacity(), new_data.Capacity());
+            data_.Swap(new_data);
+            size_ = count;
+            return;
+        }
+
+        // Иначе - присваиваем существующим элементам, создаем недостающие или удаляем лишние
+        if (count <= size_) {
+            std::copy(first, last, begin());
+            std::destroy_n(data_ + count, size_ - count);
+        }
+        else {
+            InputIt mid = std::next(first, size_);
+            std::copy(first, mid, begin());
+            std::uninitialized_copy(mid, last, end());
+        }
+        size_ = count;
+    }
+    else {
+        size_t index = 0;
+        for (; first != last && index < size_; ++first, ++index) {
+            data_[index] = *first;
+        }
+        std::destroy_n(data_ + index, size_ - index);
+        size_ = index;
+        for (; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+    }
+}
+
 /**
  * Удаляет из вектора последний элемент
 */
-template <typename T>
-void Vector<T>::PopBack() noexcept {
-    assert(size_ > 0);
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::PopBack() noexcept(CheckPolicy::NOTHROW) {
+    CheckPolicy::Check(size_ > 0, "PopBack on empty vector");
     std::destroy_at(data_ + (--size_));
+    ApplyShrinkPolicy();
 }
 /**
  * Удаляет вектор из заданной позиции
 */
-template <typename T>
-typename Vector<T>::iterator Vector<T>::Erase(const_iterator pos) {
-    assert((0 <= pos - begin()) && (static_cast<size_t>(pos - begin()) <= size_));
+template <typename T, typename Alloc, typename Traits>
+typename Vector<T, Alloc, Traits>::iterator Vector<T, Alloc, Traits>::Erase(const_iterator pos) {
+    CheckPolicy::Check(cbegin() <= pos && pos < cend(), "Erase position is out of range");
 
     size_t index = pos - begin();
     // Сдвигаем элементы из диапозона [index + 1, end()) на один элемент влево
     std::move(data_ + (index + 1), end(), data_ + index);
     // Вызовем деструктор последнего элемента, обновляем размер вектора
     std::destroy_at(data_ + (--size_));
+    ApplyShrinkPolicy();
 
     return data_ + index;
 }
+/**
+ * Удаляет элементы в диапазоне [first, last), сдвигая хвост вектора один раз,
+ * возвращает итератор на элемент, следующий за удаленными
+*/
+template <typename T, typename Alloc, typename Traits>
+typename Vector<T, Alloc, Traits>::iterator Vector<T, Alloc, Traits>::EraseRange(
+        const_iterator first, const_iterator last) {
+    CheckPolicy::Check(cbegin() <= first && first <= last && last <= cend(), "EraseRange range is invalid");
+
+    const size_t index = first - cbegin();
+    const size_t count = last - first;
+    if (count == 0) {
+        return begin() + index;
+    }
+
+    // Тривиально перемещаемые объекты удаляем и сдвигаем хвост одним блоком памяти
+    if constexpr (IsTriviallyRelocatable_v<T>) {
+        std::destroy_n(data_ + index, count);
+        std::memmove(static_cast<void*>(data_ + index), static_cast<const void*>(data_ + (index + count)),
+            (size_ - index - count) * sizeof(T));
+    }
+    else {
+        std::move(begin() + (index + count), end(), begin() + index);
+        std::destroy_n(end() - count, count);
+    }
+    size_ -= count;
+    ApplyShrinkPolicy();
+
+    return begin() + index;
+}
+/**
+ * Удаляет элемент за O(1), перенося на его место последний элемент. Порядок элементов
+ * не сохраняется. Возвращает итератор на элемент, занявший позицию pos
+*/
+template <typename T, typename Alloc, typename Traits>
+typename Vector<T, Alloc, Traits>::iterator Vector<T, Alloc, Traits>::SwapRemove(const_iterator pos) {
+    CheckPolicy::Check(cbegin() <= pos && pos < cend(), "SwapRemove position is out of range");
+
+    const size_t index = pos - cbegin();
+    const size_t last = size_ - 1;
+    if (index != last) {
+        // Тривиально перемещаемый объект переносим побайтово, не оставляя перемещенного хвоста
+        if constexpr (IsTriviallyRelocatable_v<T>) {
+            std::destroy_at(data_ + index);
+            std::memcpy(static_cast<void*>(data_ + index), static_cast<const void*>(data_ + last), sizeof(T));
+        }
+        else {
+            data_[index] = std::move(data_[last]);
+            std::destroy_at(data_ + last);
+        }
+    }
+    else {
+        std::destroy_at(data_ + last);
+    }
+    --size_;
+    ApplyShrinkPolicy();
+
+    return begin() + index;
+}
+/**
+ * Удаляет все элементы, удовлетворяющие pred, за один проход с сохранением порядка
+ * остальных. Возвращает количество удаленных элементов. Если pred выбросит исключение,
+ * вектор остается в корректном, но неопределенном состоянии
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename Predicate>
+size_t Vector<T, Alloc, Traits>::EraseIf(Predicate pred) {
+    size_t kept = 0;
+    size_t index = 0;
+
+    if constexpr (IsTriviallyRelocatable_v<T>) {
+        // Удаляемые объекты разрушаем сразу, оставшиеся переносим побайтово
+        try {
+            for (; index < size_; ++index) {
+                if (pred(std::as_const(data_[index]))) {
+                    std::destroy_at(data_ + index);
+                }
+                else {
+                    if (kept != index) {
+                        std::memcpy(static_cast<void*>(data_ + kept), static_cast<const void*>(data_ + index), sizeof(T));
+                    }
+                    ++kept;
+                }
+            }
+        }
+        catch (...) {
+            // Закрываем образовавшуюся дыру непроверенным хвостом
+            std::memmove(static_cast<void*>(data_ + kept), static_cast<const void*>(data_ + index),
+                (size_ - index) * sizeof(T));
+            size_ = kept + (size_ - index);
+            throw;
+        }
+    }
+    else {
+        for (; index < size_; ++index) {
+            if (!pred(std::as_const(data_[index]))) {
+                if (kept != index) {
+                    data_[kept] = std::move(data_[index]);
+                }
+                ++kept;
+            }
+        }
+        // Удаленные и перемещенные объекты собраны в хвосте и разрушаются один раз
+        std::destroy_n(data_ + kept, size_ - kept);
+    }
+
+    const size_t removed = size_ - kept;
+    size_ = kept;
+    ApplyShrinkPolicy();
+    return removed;
+}
+/**
+ * Удаляет все элементы, удовлетворяющие pred, не сохраняя порядок остальных:
+ * дыры в начале вектора заполняются подходящими элементами с конца, поэтому
+ * каждый оставшийся элемент перемещается не больше одного раза. Удаленные объекты
+ * разрушаются один раз в конце, pred вызывается для каждого элемента один раз.
+ * Возвращает количество удаленных элементов
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename Predicate>
+size_t Vector<T, Alloc, Traits>::RemoveIf(Predicate pred) {
+    size_t first = 0;
+    size_t last = size_;
+    while (true) {
+        while (first < last && !pred(std::as_const(data_[first]))) {
+            ++first;
+        }
+        if (first == last) {
+            break;
+        }
+        // data_[first] уже проверен, поэтому обратный проход останавливается перед ним
+        while (first + 1 < last && pred(std::as_const(data_[last - 1]))) {
+            --last;
+        }
+        if (first + 1 == last) {
+            last = first;
+            break;
+        }
+        // data_[first] удаляется, data_[last - 1] остается - переносим его в дыру
+        data_[first] = std::move(data_[last - 1]);
+        ++first;
+        --last;
+    }
+
+    std::destroy_n(data_ + last, size_ - last);
+    const size_t removed = size_ - last;
+    size_ = last;
+    ApplyShrinkPolicy();
+    return removed;
+}
 
 /**
  * Возвращает размер ветора
 */
-template <typename T>
-size_t Vector<T>::Size() const noexcept {
+template <typename T, typename Alloc, typename Traits>
+size_t Vector<T, Alloc, Traits>::Size() const noexcept {
     return size_;
 }
 /**
  * Возвращает вместимость вектора
 */
-template <typename T>
-size_t Vector<T>::Capacity() const noexcept {
+template <typename T, typename Alloc, typename Traits>
+size_t Vector<T, Alloc, Traits>::Capacity() const noexcept {
     return data_.Capacity();
 }
 
 /**
  * Константная ссылка на элемент вектора
 */
-template <typename T>
-const T& Vector<T>::operator[](size_t index) const noexcept {
-    assert(index < size_);
-    return data_[index];
+template <typename T, typename Alloc, typename Traits>
+const T& Vector<T, Alloc, Traits>::operator[](size_t index) const noexcept(CheckPolicy::NOTHROW) {
+    CheckPolicy::Check(index < size_, "Vector index is out of range");
+    return data_.GetAddress()[index];
 }
 /**
  * Ссылка на элемент вектора
 */
-template <typename T>
-T& Vector<T>::operator[](size_t index) noexcept {
-    assert(index < size_);
-    return data_[index];
+template <typename T, typename Alloc, typename Traits>
+T& Vector<T, Alloc, Traits>::operator[](size_t index) noexcept(CheckPolicy::NOTHROW) {
+    CheckPolicy::Check(index < size_, "Vector index is out of range");
+    return data_.GetAddress()[index];
+}
+/**
+ * Константная ссылка на элемент вектора без проверки индекса при любой политике проверок
+*/
+template <typename T, typename Alloc, typename Traits>
+const T& Vector<T, Alloc, Traits>::UncheckedAt(size_t index) const noexcept {
+    return data_.GetAddress()[index];
+}
+/**
+ * Ссылка на элемент вектора без проверки индекса при любой политике проверок
+*/
+template <typename T, typename Alloc, typename Traits>
+T& Vector<T, Alloc, Traits>::UncheckedAt(size_t index) noexcept {
+    return data_.GetAddress()[index];
 }
 
 /**
  * Возвращает итератор на начало вектора
 */
-template <typename T>
-typename Vector<T>::iterator Vector<T>::begin() noexcept {
+template <typename T, typename Alloc, typename Traits>
+typename Vector<T, Alloc, Traits>::iterator Vector<T, Alloc, Traits>::begin() noexcept {
     return data_.GetAddress();
 }
 /**
  * Возвращает итератор на конец вектора
 */
-template <typename T>
-typename Vector<T>::iterator Vector<T>::end() noexcept {
+template <typename T, typename Alloc, typename Traits>
+typename Vector<T, Alloc, Traits>::iterator Vector<T, Alloc, Traits>::end() noexcept {
     return data_ + size_;
 }
 /**
  * Возвращает константный итератор на начало вектора
 */
-template <typename T>
-typename Vector<T>::const_iterator Vector<T>::begin() const noexcept {
+template <typename T, typename Alloc, typename Traits>
+typename Vector<T, Alloc, Traits>::const_iterator Vector<T, Alloc, Traits>::begin() const noexcept {
     return data_.GetAddress();
 }
 /**
  * Возвращает константный итератор на конец вектора
 */
-template <typename T>
-typename Vector<T>::const_iterator Vector<T>::end() const noexcept {
+template <typename T, typename Alloc, typename Traits>
+typename Vector<T, Alloc, Traits>::const_iterator Vector<T, Alloc, Traits>::end() const noexcept {
     return data_ + size_;
 }
 /**
  * Возвращает константный итератор на начало вектора
 */
-template <typename T>
-typename Vector<T>::const_iterator Vector<T>::cbegin() const noexcept {
+template <typename T, typename Alloc, typename Traits>
+typename Vector<T, Alloc, Traits>::const_iterator Vector<T, Alloc, Traits>::cbegin() const noexcept {
     return data_.GetAddress();
 }
 /**
  * Возвращает константный итератор на конец вектора
 */
-template <typename T>
-typename Vector<T>::const_iterator Vector<T>::cend() const noexcept {
+template <typename T, typename Alloc, typename Traits>
+typename Vector<T, Alloc, Traits>::const_iterator Vector<T, Alloc, Traits>::cend() const noexcept {
     return data_ + size_;
 }
 
 /**
- * Обменивает содержимое векторов
+ * Возвращает указатель на буфер вектора
 */
-template <typename T>
-void Vector<T>::Swap(Vector& other) noexcept {
+template <typename T, typename Alloc, typename Traits>
+T* Vector<T, Alloc, Traits>::Data() noexcept {
+    return data_.GetAddress();
+}
+/**
+ * Возвращает константный указатель на буфер вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+const T* Vector<T, Alloc, Traits>::Data() const noexcept {
+    return data_.GetAddress();
+}
+/**
+ * Возвращает указатель на буфер вектора с подсказкой компилятору о его выравнивании,
+ * что позволяет векторизовать циклы выровненными загрузками. Буфер пустого вектора
+ * может быть нулевым указателем - разыменовывать его в этом случае нельзя
+*/
+template <typename T, typename Alloc, typename Traits>
+template <size_t Alignment>
+T* Vector<T, Alloc, Traits>::AssumeAligned() noexcept(CheckPolicy::NOTHROW) {
+    static_assert(Alignment <= ALIGNMENT, "Allocator does not guarantee requested alignment");
+    CheckPolicy::Check(reinterpret_cast<std::uintptr_t>(data_.GetAddress()) % Alignment == 0,
+        "Vector buffer is not aligned as requested");
+    return detail::AssumeAligned<Alignment>(data_.GetAddress());
+}
+/**
+ * Возвращает константный указатель на буфер вектора с подсказкой о его выравнивании
+*/
+template <typename T, typename Alloc, typename Traits>
+template <size_t Alignment>
+const T* Vector<T, Alloc, Traits>::AssumeAligned() const noexcept(CheckPolicy::NOTHROW) {
+    return const_cast<Vector&>(*this).template AssumeAligned<Alignment>();
+}
+
+/**
+ * Обменивает содержимое векторов. Если аллокатор не распространяется при обмене,
+ * аллокаторы векторов должны быть равны
+*/
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::Swap(Vector& other) noexcept {
+    assert(AllocTraits::propagate_on_container_swap::value 
+        || data_.GetAllocator() == other.data_.GetAllocator());
+
     data_.Swap(other.data_);
     std::swap(size_, other.size_);
 }
 
 /**
- * Безопасно перемещает или копирует n элементов из одного класса-обертки в другой,
- * очищает содержимое from
+ * Возвращает копию аллокатора вектора
 */
-template <typename T>
-void Vector<T>::MoveElements(T* from, size_t size, T* to) {
-    // Если объект типа T имеет noexcept move-конструктор или не имеет конструктора копирования - 
-    // перемещаем объекты из data_ в new_data, в противном случае копируем их
-    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-        std::uninitialized_move_n(from, size, to);
+template <typename T, typename Alloc, typename Traits>
+Alloc Vector<T, Alloc, Traits>::GetAllocator() const noexcept {
+    return data_.GetAllocator();
+}
+/**
+ * Возвращает политику статистики вектора со счетчиками, собранными этим экземпляром
+*/
+template <typename T, typename Alloc, typename Traits>
+const typename Vector<T, Alloc, Traits>::StatsPolicy& Vector<T, Alloc, Traits>::Stats() const noexcept {
+    return *this;
+}
+
+/**
+ * Возвращает вместимость, до которой следует расширить вектор, 
+ * чтобы в нем поместилось required элементов
+*/
+template <typename T, typename Alloc, typename Traits>
+size_t Vector<T, Alloc, Traits>::NextCapacity(size_t required) const noexcept {
+    return Traits::GrowthPolicy::NextCapacity(Capacity(), required, sizeof(T));
+}
+/**
+ * Переносит элементы вектора в буфер вместимостью new_capacity, не меньшей размера вектора
+*/
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::Reallocate(size_t new_capacity) {
+    assert(new_capacity >= size_ && new_capacity != 0);
+
+    // Если аллокатор умеет изменять размер блока - изменяем его, 
+    // копирование выполняется им только при невозможности сделать это на месте
+    if constexpr (CAN_REALLOCATE) {
+        const size_t old_capacity = data_.Capacity();
+        data_.Reallocate(new_capacity);
+        RecordAllocation(old_capacity, new_capacity);
+        return;
     }
-    else {
-        std::uninitialized_copy_n(from, size, to);
+
+    // Аллоцируем новый участок памяти размером new_capacity
+    Memory new_data(new_capacity, data_.GetAllocator());
+
+    detail::MoveElements<ExecutionPolicy>(data_.GetAddress(), size_, new_data.GetAddress());
+    RecordAllocation(data_.Capacity(), new_capacity);
+    RecordRelocation(size_);
+    data_.Swap(new_data);
+}
+/**
+ * Сдвигает элементы [index, end()) на один вправо в пределах вместимости и присваивает
+ * value в позицию index без временного объекта. Если value - элемент сдвигаемой части
+ * вектора, после сдвига он берется с нового места
+*/
+template <typename T, typename Alloc, typename Traits>
+template <typename Value>
+void Vector<T, Alloc, Traits>::ShiftAndAssign(size_t index, Value&& value) {
+    auto* source = std::addressof(value);
+    new (end()) T(std::move(data_[size_ - 1]));
+    std::move_backward(begin() + index, end() - 1, end());
+    if (data_ + index <= source && source < data_ + size_) {
+        ++source;
+    }
+    data_[index] = static_cast<Value&&>(*source);
+}
+/**
+ * Сообщает политике статистики о выделении нового буфера
+*/
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::RecordAllocation(size_t old_capacity, size_t new_capacity) noexcept {
+    if (new_capacity != 0) {
+        StatsPolicy::OnAllocate(old_capacity, new_capacity, new_capacity * sizeof(T));
+    }
+}
+/**
+ * Сообщает политике статистики о переносе элементов в новый буфер
+*/
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::RecordRelocation(size_t count) noexcept {
+    detail::CheckCopyFallback<Traits, T>();
+    StatsPolicy::OnRelocate(count, detail::MOVE_ELEMENTS_COPIES<T>);
+}
+/**
+ * Уменьшает вместимость вектора согласно ShrinkPolicy. Уменьшение вместимости 
+ * необязательно, поэтому при нехватке памяти вектор сохраняет текущий буфер
+*/
+template <typename T, typename Alloc, typename Traits>
+void Vector<T, Alloc, Traits>::ApplyShrinkPolicy() noexcept {
+    if constexpr (std::is_same_v<typename Traits::ShrinkPolicy, NoShrink>) {
+        return;
+    }
+
+    const size_t new_capacity = std::max(Traits::ShrinkPolicy::ShrunkCapacity(size_, data_.Capacity()), size_);
+    if (new_capacity >= data_.Capacity()) {
+        return;
+    }
+    if (new_capacity == 0) {
+        Release();
+        return;
+    }
+
+    try {
+        Reallocate(new_capacity);
+    }
+    catch (...) {
     }
-    // Освобождаем старую память
-    std::destroy_n(from, size);
 }
 
 /**
- * Класс-обертка для управления сырой памятью
+ * Класс-обертка для управления сырой памятью, выделяемой аллокатором Alloc.
+ * Аллокатор отвечает только за память, объекты в ней создаются владельцем RawMemory.
+ * Смещения и индексы проверяются политикой CheckPolicy
 */
-template <typename T>
+template <typename T, typename Alloc, typename CheckPolicy>
 class RawMemory {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
 public:
     RawMemory() = default;
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
+    explicit RawMemory(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+    explicit RawMemory(size_t capacity, const Alloc& alloc = Alloc())
+        : alloc_(alloc)
+        , buffer_(Allocate(capacity))
         , capacity_(capacity) {
     }
 
     RawMemory(const RawMemory& other) = delete;
     RawMemory(RawMemory&& other) noexcept
-        : buffer_(std::move(other.buffer_))
+        : alloc_(std::move(other.alloc_))
+        , buffer_(std::move(other.buffer_))
         , capacity_(other.capacity_)
     {
         other.buffer_ = nullptr;
@@ -459,11 +1835,17 @@ public:
     }
 
     RawMemory& operator=(const RawMemory& other) = delete;
-    RawMemory& operator=(RawMemory&& other) {
-        if (buffer_ != nullptr) {
-            Deallocate(buffer_);
-        }
+    /**
+     * Перемещающее присваивание, аллокатор перенимается согласно
+     * propagate_on_container_move_assignment. Если аллокатор не распространяется,
+     * аллокаторы должны быть равны
+    */
+    RawMemory& operator=(RawMemory&& other) noexcept {
+        Deallocate(buffer_, capacity_);
 
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+            alloc_ = std::move(other.alloc_);
+        }
         buffer_ = std::move(other.buffer_);
         capacity_ = other.capacity_;
 
@@ -474,32 +1856,62 @@ public:
     }
 
     ~RawMemory() {
-        Deallocate(buffer_);
+        Deallocate(buffer_, capacity_);
     }
 
-    T* operator+(size_t offset) noexcept {
+    T* operator+(size_t offset) noexcept(CheckPolicy::NOTHROW) {
         // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
-        assert(offset <= capacity_);
+        CheckPolicy::Check(offset <= capacity_, "RawMemory offset is out of range");
         return buffer_ + offset;
     }
 
-    const T* operator+(size_t offset) const noexcept {
-        return const_cast<RawMemory&>(*this) + offset;
+    const T* operator+(size_t offset) const noexcept(CheckPolicy::NOTHROW) {
+        CheckPolicy::Check(offset <= capacity_, "RawMemory offset is out of range");
+        return buffer_ + offset;
     }
 
-    const T& operator[](size_t index) const noexcept {
-        return const_cast<RawMemory&>(*this)[index];
+    const T& operator[](size_t index) const noexcept(CheckPolicy::NOTHROW) {
+        CheckPolicy::Check(index < capacity_, "RawMemory index is out of range");
+        return buffer_[index];
     }
-    T& operator[](size_t index) noexcept {
-        assert(index < capacity_);
+    T& operator[](size_t index) noexcept(CheckPolicy::NOTHROW) {
+        CheckPolicy::Check(index < capacity_, "RawMemory index is out of range");
         return buffer_[index];
     }
 
+    /**
+     * Обменивает буферы, аллокаторы обмениваются согласно propagate_on_container_swap
+    */
     void Swap(RawMemory& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        }
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
 
+    /**
+     * Изменяет вместимость буфера методом аллокатора reallocate, содержимое
+     * буфера сохраняется побайтово. Доступен только для аллокаторов с HasReallocate
+    */
+    void Reallocate(size_t new_capacity) {
+        static_assert(HasReallocate_v<Alloc>, "Alloc does not provide reallocate");
+
+        buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+        capacity_ = new_capacity;
+    }
+
+    /**
+     * Освобождает буфер текущим аллокатором и заменяет аллокатор на alloc
+    */
+    void ResetAllocator(const Alloc& alloc) {
+        Deallocate(buffer_, capacity_);
+        buffer_ = nullptr;
+        capacity_ = 0;
+        alloc_ = alloc;
+    }
+
     const T* GetAddress() const noexcept {
         return buffer_;
     }
@@ -511,20 +1923,37 @@ public:
         return capacity_;
     }
 
+    const Alloc& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
 private:
     /**
      * Выделяет сырую память под n элементов и возвращает указатель на неё
     */
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    T* Allocate(size_t n) {
+        return n != 0 ? AllocTraits::allocate(alloc_, n) : nullptr;
     }
     /**
-     * Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
+     * Освобождает сырую память под n элементов, выделенную ранее по адресу buf при помощи Allocate
     */
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    void Deallocate(T* buf, size_t n) noexcept {
+        if (buf != nullptr) {
+            AllocTraits::deallocate(alloc_, buf, n);
+        }
     }
 
+    Alloc alloc_;
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
+
+namespace pmr {
+
+/**
+ * Вектор, получающий память из std::pmr::memory_resource
+*/
+template <typename T>
+using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>>;
+
+} // namespace pmr
@@ -0,0 +1,168 @@
+#pragma once
+#include "vector.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <utility>
+
+/**
+ * Задача сопрограммы, заполняющей вектор. Сопрограмма начинает выполняться сразу
+ * при вызове и приостанавливается на ожидании данных. Результат — количество
+ * добавленных элементов — доступен через Get() после завершения или через co_await
+ * из другой сопрограммы. Разрушение задачи разрушает и приостановленную сопрограмму
+*/
+class VectorFillTask {
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    VectorFillTask(VectorFillTask&& other) noexcept;
+    VectorFillTask& operator=(VectorFillTask&& other) noexcept;
+    ~VectorFillTask() noexcept;
+
+    bool IsDone() const noexcept;
+    size_t Get() const;
+
+    bool await_ready() const noexcept;
+    void await_suspend(std::coroutine_handle<> awaiting) noexcept;
+    size_t await_resume() const;
+
+private:
+    Handle handle_;
+
+    explicit VectorFillTask(Handle handle) noexcept;
+};
+
+struct VectorFillTask::promise_type {
+    size_t result = 0;
+    std::exception_ptr exception;
+    std::coroutine_handle<> continuation; // Сопрограмма, ожидающая завершения задачи
+
+    // Передает управление ожидающей сопрограмме, если она есть
+    struct FinalAwaiter {
+        bool await_ready() const noexcept {
+            return false;
+        }
+        std::coroutine_handle<> await_suspend(Handle handle) noexcept {
+            const std::coroutine_handle<> continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+        void await_resume() const noexcept {
+        }
+    };
+
+    VectorFillTask get_return_object() noexcept {
+        return VectorFillTask(Handle::from_promise(*this));
+    }
+    std::suspend_never initial_suspend() const noexcept {
+        return {};
+    }
+    FinalAwaiter final_suspend() const noexcept {
+        return {};
+    }
+    void return_value(size_t appended) noexcept {
+        result = appended;
+    }
+    void unhandled_exception() noexcept {
+        exception = std::current_exception();
+    }
+};
+
+/**
+ * Сопрограмма, добавляющая в конец target фрагменты по мере их поступления.
+ * read(T* data, size_t n) возвращает ожидаемый объект, который записывает до n
+ * элементов прямо в хвост вектора и возвращает их количество; 0 означает конец потока.
+ * Хвост запрашивается через GetWriteBuffer не меньше чем на chunk_size элементов.
+ * target должен существовать до завершения сопрограммы; при исключении в векторе
+ * остаются фрагменты, полученные до него
+*/
+template <typename T, typename Alloc, typename Traits, typename AsyncRead>
+VectorFillTask AppendChunks(Vector<T, Alloc, Traits>& target, AsyncRead read, size_t chunk_size) {
+    size_t appended = 0;
+    for (;;) {
+        const WriteBuffer<T> buffer = target.GetWriteBuffer(chunk_size);
+        const size_t received = co_await read(buffer.data, buffer.size);
+        if (received == 0) {
+            break;
+        }
+        target.Commit(received);
+        appended += received;
+    }
+    co_return appended;
+}
+
+/**
+ * Конструктор, принимает владение сопрограммой
+*/
+inline VectorFillTask::VectorFillTask(Handle handle) noexcept
+    : handle_(handle)
+{}
+/**
+ * Конструктор перемещения
+*/
+inline VectorFillTask::VectorFillTask(VectorFillTask&& other) noexcept
+    : handle_(std::exchange(other.handle_, nullptr))
+{}
+/**
+ * Оператор перемещающего присваивания
+*/
+inline VectorFillTask& VectorFillTask::operator=(VectorFillTask&& other) noexcept {
+    if (this != &other) {
+        if (handle_) {
+            handle_.destroy();
+        }
+        handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+}
+/**
+ * Деструктор, разрушает сопрограмму
+*/
+inline VectorFillTask::~VectorFillTask() noexcept {
+    if (handle_) {
+        handle_.destroy();
+    }
+}
+
+/**
+ * Проверяет, завершилась ли сопрограмма
+*/
+inline bool VectorFillTask::IsDone() const noexcept {
+    return handle_ && handle_.done();
+}
+/**
+ * Возвращает количество добавленных элементов завершенной сопрограммы
+ * или выбрасывает исключение, которым она завершилась
+*/
+inline size_t VectorFillTask::Get() const {
+    assert(IsDone());
+    if (handle_.promise().exception) {
+        std::rethrow_exception(handle_.promise().exception);
+    }
+    return handle_.promise().result;
+}
+
+/**
+ * Ожидание не приостанавливает сопрограмму, если задача уже завершена
+*/
+inline bool VectorFillTask::await_ready() const noexcept {
+    return IsDone();
+}
+/**
+ * Запоминает ожидающую сопрограмму, задача возобновит ее при завершении
+*/
+inline void VectorFillTask::await_suspend(std::coroutine_handle<> awaiting) noexcept {
+    handle_.promise().continuation = awaiting;
+}
+/**
+ * Результат ожидания
+*/
+inline size_t VectorFillTask::await_resume() const {
+    return Get();
+}
+
+#endif // __cpp_impl_coroutine
@@ -0,0 +1,274 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+/**
+ * Заголовок сериализованного вектора. Поля записываются в порядке байт машины,
+ * что позволяет читающей стороне обнаружить несовпадение по полю magic
+*/
+struct VectorIoHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;   // Размер заголовка, новые версии могут дописывать поля в конец
+    uint64_t element_size;
+    uint64_t size;          // Количество элементов
+};
+
+inline constexpr uint32_t VECTOR_IO_MAGIC = 0x56444156;  // "VADV"
+inline constexpr uint16_t VECTOR_IO_VERSION = 1;
+
+namespace detail {
+
+/**
+ * Проверяет заголовок и возвращает количество байт данных. При несовпадении
+ * формата выбрасывает std::system_error с кодом invalid_argument
+*/
+template <typename T>
+size_t CheckIoHeader(const VectorIoHeader& header) {
+    if (header.magic != VECTOR_IO_MAGIC || header.version == 0 || header.version > VECTOR_IO_VERSION
+            || header.header_size < sizeof(VectorIoHeader)) {
+        throw std::system_error(std::make_error_code(std::errc::invalid_argument), "VectorIo: bad header");
+    }
+    if (header.element_size != sizeof(T)) {
+        throw std::system_error(std::make_error_code(std::errc::invalid_argument), "VectorIo: element size mismatch");
+    }
+    if (header.size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+        throw std::system_error(std::make_error_code(std::errc::value_too_large), "VectorIo: vector is too large");
+    }
+    return static_cast<size_t>(header.size) * sizeof(T);
+}
+
+/**
+ * Записывает все буферы iov, повторяя writev после частичной записи и EINTR
+*/
+inline void WriteAll(int fd, iovec* iov, int count) {
+    while (count > 0) {
+        const ssize_t written = ::writev(fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+
+        size_t rest = static_cast<size_t>(written);
+        while (count > 0 && rest >= iov->iov_len) {
+            rest -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + rest;
+            iov->iov_len -= rest;
+        }
+    }
+}
+
+/**
+ * Читает bytes байт в buf. Возвращает количество прочитанных байт,
+ * меньшее bytes только при достижении конца файла
+*/
+inline size_t ReadAll(int fd, void* buf, size_t bytes) {
+    size_t total = 0;
+    while (total < bytes) {
+        const ssize_t got = ::read(fd, static_cast<char*>(buf) + total, bytes - total);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+        if (got == 0) {
+            break;
+        }
+        total += static_cast<size_t>(got);
+    }
+    return total;
+}
+
+[[noreturn]] inline void ThrowUnexpectedEof() {
+    throw std::system_error(std::make_error_code(std::errc::io_error), "VectorIo: unexpected end of file");
+}
+
+} // namespace detail
+
+/**
+ * Формирует заголовок для вектора v
+*/
+template <typename T, typename Alloc, typename Traits>
+VectorIoHeader MakeIoHeader(const Vector<T, Alloc, Traits>& v) noexcept {
+    return VectorIoHeader{VECTOR_IO_MAGIC, VECTOR_IO_VERSION, sizeof(VectorIoHeader), sizeof(T), v.Size()};
+}
+
+/**
+ * Записывает вектор в дескриптор fd: заголовок и непрерывный буфер элементов
+ * передаются одним вызовом writev. Ошибки ввода-вывода выбрасываются как std::system_error
+*/
+template <typename T, typename Alloc, typename Traits>
+void WriteTo(int fd, const Vector<T, Alloc, Traits>& v) {
+    static_assert(std::is_trivially_copyable_v<T>, "WriteTo requires trivially copyable T");
+
+    VectorIoHeader header = MakeIoHeader(v);
+    iovec iov[2] = {
+        {&header, sizeof(header)},
+        {const_cast<T*>(v.Data()), v.Size() * sizeof(T)},
+    };
+    detail::WriteAll(fd, iov, v.Size() == 0 ? 1 : 2);
+}
+
+/**
+ * Заменяет содержимое вектора данными, прочитанными из fd. Элементы читаются прямо
+ * в неинициализированную память вектора без предварительной инициализации.
+ * При ошибке выбрасывает std::system_error, вектор при этом остается пустым
+*/
+template <typename T, typename Alloc, typename Traits>
+void ReadFrom(int fd, Vector<T, Alloc, Traits>& v) {
+    static_assert(std::is_trivially_copyable_v<T>, "ReadFrom requires trivially copyable T");
+
+    VectorIoHeader header{};
+    if (detail::ReadAll(fd, &header, sizeof(header)) != sizeof(header)) {
+        detail::ThrowUnexpectedEof();
+    }
+    const size_t bytes = detail::CheckIoHeader<T>(header);
+
+    // Пропускаем поля заголовка, добавленные более новыми версиями
+    char skipped[64];
+    for (size_t rest = header.header_size - sizeof(header); rest > 0; ) {
+        const size_t chunk = std::min(rest, sizeof(skipped));
+        if (detail::ReadAll(fd, skipped, chunk) != chunk) {
+            detail::ThrowUnexpectedEof();
+        }
+        rest -= chunk;
+    }
+
+    const size_t size = bytes / sizeof(T);
+    v.Clear();
+    v.Reserve(size);
+    v.ResizeAndOverwrite(size, [fd, bytes](T* data, size_t n) {
+        if (detail::ReadAll(fd, data, bytes) != bytes) {
+            detail::ThrowUnexpectedEof();
+        }
+        return n;
+    });
+}
+
+/**
+ * Потоковая запись вектора для передачи по сети: вызывает send(const void* data, size_t bytes)
+ * для заголовка и для последовательных частей буфера размером не больше chunk_bytes.
+ * Формат совпадает с WriteTo, данные передаются без промежуточного копирования
+*/
+template <typename T, typename Alloc, typename Traits, typename Send>
+void WriteChunks(const Vector<T, Alloc, Traits>& v, size_t chunk_bytes, Send&& send) {
+    static_assert(std::is_trivially_copyable_v<T>, "WriteChunks requires trivially copyable T");
+    assert(chunk_bytes > 0);
+
+    const VectorIoHeader header = MakeIoHeader(v);
+    send(static_cast<const void*>(&header), sizeof(header));
+
+    const char* data = reinterpret_cast<const char*>(v.Data());
+    const size_t bytes = v.Size() * sizeof(T);
+    for (size_t offset = 0; offset < bytes; offset += chunk_bytes) {
+        send(static_cast<const void*>(data + offset), std::min(chunk_bytes, bytes - offset));
+    }
+}
+
+/**
+ * Потоковое чтение вектора из частей произвольного размера, например из сетевых пакетов.
+ * Данные копируются прямо в зарезервированную память целевого вектора; после каждой
+ * части вектор содержит все полностью полученные элементы
+*/
+template <typename T, typename Alloc = std::allocator<T>, typename Traits = DefaultVectorTraits>
+class VectorStreamReader {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "VectorStreamReader requires trivially copyable T");
+
+    explicit VectorStreamReader(Vector<T, Alloc, Traits>& target) noexcept;
+
+    size_t Feed(const void* data, size_t bytes);
+    bool IsComplete() const noexcept;
+
+private:
+    Vector<T, Alloc, Traits>& target_;
+    VectorIoHeader header_{};
+    size_t header_received_ = 0;
+    size_t payload_bytes_ = 0;
+    size_t payload_received_ = 0;
+    bool has_header_ = false;
+};
+
+/**
+ * Создает читатель, заполняющий вектор target
+*/
+template <typename T, typename Alloc, typename Traits>
+VectorStreamReader<T, Alloc, Traits>::VectorStreamReader(Vector<T, Alloc, Traits>& target) noexcept
+    : target_(target)
+{
+}
+/**
+ * Принимает очередную часть потока. Возвращает количество использованных байт:
+ * оно меньше bytes, если в части после конца вектора идут посторонние данные.
+ * При неверном заголовке выбрасывает std::system_error
+*/
+template <typename T, typename Alloc, typename Traits>
+size_t VectorStreamReader<T, Alloc, Traits>::Feed(const void* data, size_t bytes) {
+    const char* input = static_cast<const char*>(data);
+    size_t consumed = 0;
+
+    if (!has_header_) {
+        if (header_received_ < sizeof(header_)) {
+            const size_t chunk = std::min(bytes, sizeof(header_) - header_received_);
+            std::memcpy(reinterpret_cast<char*>(&header_) + header_received_, input, chunk);
+            header_received_ += chunk;
+            consumed += chunk;
+            if (header_received_ < sizeof(header_)) {
+                return consumed;
+            }
+            payload_bytes_ = detail::CheckIoHeader<T>(header_);
+        }
+
+        // Пропускаем поля заголовка, добавленные более новыми версиями
+        const size_t skipped = std::min(bytes - consumed, header_.header_size - header_received_);
+        header_received_ += skipped;
+        consumed += skipped;
+        if (header_received_ < header_.header_size) {
+            return consumed;
+        }
+
+        has_header_ = true;
+        target_.Clear();
+        target_.Reserve(payload_bytes_ / sizeof(T));
+    }
+
+    const size_t chunk = std::min(bytes - consumed, payload_bytes_ - payload_received_);
+    if (chunk != 0) {
+        // Хвост зарезервирован под весь вектор, поэтому GetWriteBuffer не перевыделяет буфер
+        // и байты недополученного элемента сохраняются. Commit учитывает только целые
+        // элементы и, в отличие от изменения размера, не применяет политику уменьшения
+        const size_t committed_bytes = target_.Size() * sizeof(T);
+        const WriteBuffer<T> buffer = target_.GetWriteBuffer(payload_bytes_ / sizeof(T) - target_.Size());
+        std::memcpy(reinterpret_cast<char*>(buffer.data) + (payload_received_ - committed_bytes),
+            input + consumed, chunk);
+        payload_received_ += chunk;
+        consumed += chunk;
+        target_.Commit(payload_received_ / sizeof(T) - target_.Size());
+    }
+    return consumed;
+}
+/**
+ * Проверяет, что вектор получен полностью
+*/
+template <typename T, typename Alloc, typename Traits>
+bool VectorStreamReader<T, Alloc, Traits>::IsComplete() const noexcept {
+    return has_header_ && payload_received_ == payload_bytes_;
+}
@@ -0,0 +1,227 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+
+/**
+ * Счетчики работы с памятью вектора
+*/
+struct VectorStats {
+    size_t allocations = 0;       // Выделено буферов
+    size_t allocated_bytes = 0;   // Суммарный размер выделенных буферов
+    size_t reallocations = 0;     // Выделений, заменивших непустой буфер
+    size_t moved_elements = 0;    // Элементов, перенесенных перемещением или побайтово
+    size_t copied_elements = 0;   // Элементов, перенесенных копированием
+    size_t peak_capacity = 0;     // Наибольшая вместимость
+};
+
+/**
+ * Политика статистики, собирающая счетчики каждого вектора отдельно.
+ * Счетчики доступны через Vector::Stats()
+*/
+struct InstanceStats : VectorStats {
+    void OnAllocate(size_t old_capacity, size_t new_capacity, size_t bytes) noexcept {
+        ++allocations;
+        allocated_bytes += bytes;
+        if (old_capacity != 0) {
+            ++reallocations;
+        }
+        peak_capacity = std::max(peak_capacity, new_capacity);
+    }
+    void OnRelocate(size_t count, bool copied) noexcept {
+        (copied ? copied_elements : moved_elements) += count;
+    }
+};
+
+/**
+ * Запись глобального реестра статистики. Счетчики общие для всех векторов
+ * с одним тегом и могут обновляться из разных потоков
+*/
+class VectorStatsEntry {
+public:
+    explicit VectorStatsEntry(std::string_view name) noexcept;
+
+    VectorStatsEntry(const VectorStatsEntry&) = delete;
+    VectorStatsEntry& operator=(const VectorStatsEntry&) = delete;
+
+    void OnAllocate(size_t old_capacity, size_t new_capacity, size_t bytes) noexcept;
+    void OnRelocate(size_t count, bool copied) noexcept;
+
+    std::string_view Name() const noexcept;
+    VectorStats Load() const noexcept;
+    void Reset() noexcept;
+
+private:
+    friend class VectorStatsRegistry;
+
+    std::string_view name_;
+    std::atomic<size_t> allocations_{0};
+    std::atomic<size_t> allocated_bytes_{0};
+    std::atomic<size_t> reallocations_{0};
+    std::atomic<size_t> moved_elements_{0};
+    std::atomic<size_t> copied_elements_{0};
+    std::atomic<size_t> peak_capacity_{0};
+    // Записи связаны в список без выделения памяти
+    VectorStatsEntry* next_ = nullptr;
+};
+
+/**
+ * Глобальный реестр статистики векторов, использующих RegisteredStats
+*/
+class VectorStatsRegistry {
+public:
+    static VectorStatsRegistry& Instance() noexcept;
+
+    void Register(VectorStatsEntry& entry) noexcept;
+
+    // Вызывает callback(name, stats) для каждой записи в порядке регистрации
+    template <typename Callback>
+    void ForEach(Callback&& callback) const;
+
+    void Dump(std::ostream& out) const;
+    void Reset() noexcept;
+
+private:
+    VectorStatsRegistry() = default;
+
+    mutable std::mutex mutex_;
+    VectorStatsEntry* head_ = nullptr;
+    VectorStatsEntry* tail_ = nullptr;
+};
+
+/**
+ * Политика статистики, ведущая счетчики экземпляра и суммирующая их в запись
+ * реестра с именем Tag::NAME. Запись регистрируется при первом обращении
+*/
+template <typename Tag>
+struct RegisteredStats : InstanceStats {
+    static VectorStatsEntry& Entry() noexcept {
+        static VectorStatsEntry entry(Tag::NAME);
+        return entry;
+    }
+
+    void OnAllocate(size_t old_capacity, size_t new_capacity, size_t bytes) noexcept {
+        InstanceStats::OnAllocate(old_capacity, new_capacity, bytes);
+        Entry().OnAllocate(old_capacity, new_capacity, bytes);
+    }
+    void OnRelocate(size_t count, bool copied) noexcept {
+        InstanceStats::OnRelocate(count, copied);
+        Entry().OnRelocate(count, copied);
+    }
+};
+
+/**
+ * Создает запись и регистрирует ее в глобальном реестре
+*/
+inline VectorStatsEntry::VectorStatsEntry(std::string_view name) noexcept
+    : name_(name)
+{
+    VectorStatsRegistry::Instance().Register(*this);
+}
+/**
+ * Учитывает выделение буфера
+*/
+inline void VectorStatsEntry::OnAllocate(size_t old_capacity, size_t new_capacity, size_t bytes) noexcept {
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    if (old_capacity != 0) {
+        reallocations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    size_t peak = peak_capacity_.load(std::memory_order_relaxed);
+    while (peak < new_capacity
+            && !peak_capacity_.compare_exchange_weak(peak, new_capacity, std::memory_order_relaxed)) {
+    }
+}
+/**
+ * Учитывает перенос элементов
+*/
+inline void VectorStatsEntry::OnRelocate(size_t count, bool copied) noexcept {
+    (copied ? copied_elements_ : moved_elements_).fetch_add(count, std::memory_order_relaxed);
+}
+/**
+ * Возвращает имя записи
+*/
+inline std::string_view VectorStatsEntry::Name() const noexcept {
+    return name_;
+}
+/**
+ * Возвращает снимок счетчиков. Счетчики читаются независимо, поэтому при
+ * параллельных изменениях снимок может быть несогласованным
+*/
+inline VectorStats VectorStatsEntry::Load() const noexcept {
+    VectorStats stats;
+    stats.allocations = allocations_.load(std::memory_order_relaxed);
+    stats.allocated_bytes = allocated_bytes_.load(std::memory_order_relaxed);
+    stats.reallocations = reallocations_.load(std::memory_order_relaxed);
+    stats.moved_elements = moved_elements_.load(std::memory_order_relaxed);
+    stats.copied_elements = copied_elements_.load(std::memory_order_relaxed);
+    stats.peak_capacity = peak_capacity_.load(std::memory_order_relaxed);
+    return stats;
+}
+/**
+ * Обнуляет счетчики
+*/
+inline void VectorStatsEntry::Reset() noexcept {
+    allocations_.store(0, std::memory_order_relaxed);
+    allocated_bytes_.store(0, std::memory_order_relaxed);
+    reallocations_.store(0, std::memory_order_relaxed);
+    moved_elements_.store(0, std::memory_order_relaxed);
+    copied_elements_.store(0, std::memory_order_relaxed);
+    peak_capacity_.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Возвращает единственный экземпляр реестра
+*/
+inline VectorStatsRegistry& VectorStatsRegistry::Instance() noexcept {
+    static VectorStatsRegistry registry;
+    return registry;
+}
+/**
+ * Добавляет запись в конец списка
+*/
+inline void VectorStatsRegistry::Register(VectorStatsEntry& entry) noexcept {
+    std::lock_guard lock(mutex_);
+    if (tail_ == nullptr) {
+        head_ = &entry;
+    } else {
+        tail_->next_ = &entry;
+    }
+    tail_ = &entry;
+}
+/**
+ * Обходит записи реестра
+*/
+template <typename Callback>
+void VectorStatsRegistry::ForEach(Callback&& callback) const {
+    std::lock_guard lock(mutex_);
+    for (const VectorStatsEntry* entry = head_; entry != nullptr; entry = entry->next_) {
+        callback(entry->Name(), entry->Load());
+    }
+}
+/**
+ * Выводит счетчики всех записей, по одной строке на запись
+*/
+inline void VectorStatsRegistry::Dump(std::ostream& out) const {
+    ForEach([&out](std::string_view name, const VectorStats& stats) {
+        out << name << ": allocations=" << stats.allocations
+            << " allocated_bytes=" << stats.allocated_bytes
+            << " reallocations=" << stats.reallocations
+            << " moved=" << stats.moved_elements
+            << " copied=" << stats.copied_elements
+            << " peak_capacity=" << stats.peak_capacity << '\n';
+    });
+}
+/**
+ * Обнуляет счетчики всех записей
+*/
+inline void VectorStatsRegistry::Reset() noexcept {
+    std::lock_guard lock(mutex_);
+    for (VectorStatsEntry* entry = head_; entry != nullptr; entry = entry->next_) {
+        entry->Reset();
+    }
+}